@@ -0,0 +1,319 @@
+/*
+ * hotpath_bench — the daemon's hot paths, timed on captured fixtures
+ *
+ * Covers everything that runs per event or per resync and builds without
+ * GTK: the `-j` reply parsers (including the [[BATCH]] snapshot), socket2
+ * line dispatch, palette parsing and dot-strip layout.  Each benchmark is
+ * calibrated to ~1 ms per sample and sampled repeatedly; the median and
+ * the median absolute deviation are reported as TSV (benchrun.h) so runs
+ * can be diffed or fed to a regression check.  Model update and drawing
+ * need the daemon's GTK build and report the same rows from
+ * `workspace-indicator --render-bench`; `make bench-all` runs both.
+ *
+ * Fixtures default to bench/fixtures/ (monitors.json, workspaces.json,
+ * activeworkspace.json, clients.json, events.socket2, palette.conf); point
+ * -d at another directory to time real captures, e.g. `hyprctl -j
+ * monitors > monitors.json` or a socket2 stream saved with `socat`.
+ *
+ * Usage: bench/hotpath-bench [-d fixture-dir] [-n samples]
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../benchrun.h"
+#include "../indicator.h"
+#include "../json.h"
+#include "../palette.h"
+#include "../socket2.h"
+#include "../strip.h"
+#include "../wsset.h"
+
+enum { CHUNK = 4096 };
+
+static volatile long sink;
+
+static void die(const char *msg)
+{
+    fprintf(stderr, "hotpath-bench: %s\n", msg);
+    exit(1);
+}
+
+/* ── Fixtures ────────────────────────────────────────────────────── */
+
+typedef struct {
+    char  *data;
+    size_t len;
+} Blob;
+
+static Blob load(const char *dir, const char *name)
+{
+    char path[1024];
+    snprintf(path, sizeof path, "%s/%s", dir, name);
+
+    FILE *f = fopen(path, "rb");
+    if (!f) { perror(path); exit(2); }
+
+    Blob   b = {0};
+    size_t cap = 0, n;
+    char   tmp[65536];
+    while ((n = fread(tmp, 1, sizeof tmp, f)) > 0) {
+        if (b.len + n + 1 > cap) {
+            cap    = (b.len + n + 1) * 2;
+            b.data = realloc(b.data, cap);
+            if (!b.data) die("out of memory");
+        }
+        memcpy(b.data + b.len, tmp, n);
+        b.len += n;
+    }
+    fclose(f);
+    if (!b.data) die("empty fixture");
+    b.data[b.len] = '\0';
+    return b;
+}
+
+static Blob monitors_js, workspaces_js, active_js, clients_js, batch_js;
+static Blob events, palette_conf;
+static size_t event_lines;
+
+/* ── Benchmarks ──────────────────────────────────────────────────── */
+
+static HyprMonitor   mons[MAX_MONS];
+static HyprWorkspace *wss;             /* sized from the fixture, as the daemon does */
+static int            wss_cap;
+static HyprClient    clients[MAX_CLIENTS];
+
+static void b_monitors(void *ctx)
+{
+    (void)ctx;
+    JsonCursor c;
+    json_cursor_init(&c, monitors_js.data, monitors_js.len);
+    sink += json_parse_monitors(&c, mons, MAX_MONS);
+}
+
+static void b_workspaces(void *ctx)
+{
+    (void)ctx;
+    JsonCursor c;
+    json_cursor_init(&c, workspaces_js.data, workspaces_js.len);
+    sink += json_parse_workspaces(&c, wss, wss_cap);
+}
+
+static void b_activeworkspace(void *ctx)
+{
+    (void)ctx;
+    JsonCursor    c;
+    HyprWorkspace ws;
+    json_cursor_init(&c, active_js.data, active_js.len);
+    sink += json_parse_workspace(&c, &ws) ? ws.id : 0;
+}
+
+static void b_clients(void *ctx)
+{
+    (void)ctx;
+    JsonCursor c;
+    json_cursor_init(&c, clients_js.data, clients_js.len);
+    sink += json_parse_clients(&c, clients, MAX_CLIENTS);
+}
+
+/* hypr_snapshot(): the three replies of one [[BATCH]] back to back. */
+static void b_batch(void *ctx)
+{
+    (void)ctx;
+    JsonCursor    c;
+    HyprWorkspace ws;
+    json_cursor_init(&c, batch_js.data, batch_js.len);
+    sink += json_parse_monitors(&c, mons, MAX_MONS);
+    sink += json_parse_workspaces(&c, wss, wss_cap);
+    sink += json_parse_workspace(&c, &ws);
+}
+
+static void ev_count(char *payload, size_t len, void *user)
+{
+    (void)payload; (void)user;
+    sink += (long)len;
+}
+
+/* The daemon's ipc_events[] names (indicator.h), with no-op handlers. */
+#define BENCH_EVENT(name, fn) S2_EVENT(name, ev_count)
+static const S2Event s2_events[] = { WI_IPC_EVENTS(BENCH_EVENT) };
+
+static S2Reader s2;
+
+static void b_socket2(void *ctx)
+{
+    (void)ctx;
+    for (size_t off = 0; off < events.len; ) {
+        size_t avail;
+        char  *dst = s2_reader_space(&s2, &avail);
+        size_t n   = events.len - off;
+        if (n > avail) n = avail;
+        if (n > CHUNK) n = CHUNK;
+        memcpy(dst, events.data + off, n);        /* stands in for read() */
+        s2_reader_commit(&s2, n);
+        off += n;
+    }
+}
+
+static void b_palette(void *ctx)
+{
+    (void)ctx;
+    Palette p = {0};
+    FILE   *f = fmemopen(palette_conf.data, palette_conf.len, "r");
+    palette_parse(f, &p);
+    fclose(f);
+    sink += (long)(p.active.r * 255);
+}
+
+static void b_hex8(void *ctx)
+{
+    (void)ctx;
+    sink += (long)(hex8_to_rgba("7fb4c9ff").g * 255);
+}
+
+typedef struct {
+    WsSet view, all;
+    int   active;
+} StripCase;
+
+static int some_windows(int ws, void *user)
+{
+    (void)user;
+    return ws & 3;
+}
+
+static const StripParams strip_params = {
+    .persistent = PERSISTENT_WS,
+    .max_dots   = MAX_DOTS,
+    .win_steps  = WIN_STEPS,
+    .win_count  = some_windows,
+};
+
+static void b_strip(void *ctx)
+{
+    StripCase *sc = ctx;
+    DotStrip   d;
+    strip_layout(&d, &sc->view, &sc->all, sc->active, &strip_params);
+    sink += d.n;
+}
+
+/* ── main ────────────────────────────────────────────────────────── */
+
+static void strip_case(StripCase *sc, int lo, int hi, int active)
+{
+    wsset_init(&sc->view);
+    wsset_init(&sc->all);
+    for (int ws = lo; ws <= hi; ws++) {
+        wsset_add(&sc->view, ws);
+        wsset_add(&sc->all, ws);
+        wsset_set_monitor(&sc->all, ws, 0);
+    }
+    sc->active = active;
+}
+
+int main(int argc, char **argv)
+{
+    const char *dir     = "bench/fixtures";
+    int         samples = 21;
+    int         opt;
+
+    while ((opt = getopt(argc, argv, "d:n:")) != -1) {
+        switch (opt) {
+        case 'd': dir     = optarg;       break;
+        case 'n': samples = atoi(optarg); break;
+        default:
+            fprintf(stderr, "usage: %s [-d fixture-dir] [-n samples]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (samples < 3) samples = 3;
+
+    monitors_js   = load(dir, "monitors.json");
+    workspaces_js = load(dir, "workspaces.json");
+    active_js     = load(dir, "activeworkspace.json");
+    clients_js    = load(dir, "clients.json");
+    events        = load(dir, "events.socket2");
+    palette_conf  = load(dir, "palette.conf");
+
+    batch_js.len  = monitors_js.len + workspaces_js.len + active_js.len;
+    batch_js.data = malloc(batch_js.len + 1);
+    if (!batch_js.data) die("out of memory");
+    memcpy(batch_js.data, monitors_js.data, monitors_js.len);
+    memcpy(batch_js.data + monitors_js.len, workspaces_js.data, workspaces_js.len);
+    memcpy(batch_js.data + monitors_js.len + workspaces_js.len, active_js.data, active_js.len);
+    batch_js.data[batch_js.len] = '\0';
+
+    for (size_t i = 0; i < events.len; i++)
+        event_lines += events.data[i] == '\n';
+    s2_reader_init(&s2, s2_events, sizeof s2_events / sizeof *s2_events, BUF_SZ, NULL);
+
+    /* Sanity: the fixtures must parse before their timings mean anything. */
+    JsonCursor    c;
+    HyprWorkspace aws;
+    json_cursor_init(&c, batch_js.data, batch_js.len);
+    int nm = json_parse_monitors(&c, mons, MAX_MONS);
+    JsonCursor wc;
+    json_cursor_init(&wc, workspaces_js.data, workspaces_js.len);
+    wss_cap = json_count(&wc);
+    wss     = malloc((size_t)(wss_cap > 0 ? wss_cap : 1) * sizeof *wss);
+    if (!wss) die("out of memory");
+    int nw = json_parse_workspaces(&c, wss, wss_cap);
+    if (nm < 1 || nw < 1 || !json_parse_workspace(&c, &aws))
+        die("batch fixture does not parse");
+    json_cursor_init(&c, clients_js.data, clients_js.len);
+    if (json_parse_clients(&c, clients, MAX_CLIENTS) < 1)
+        die("clients fixture does not parse");
+    if (event_lines == 0)
+        die("socket2 fixture has no lines");
+
+    /* Strips: persistent slots only, the fixture's layout, a scrolled
+     * window, and a few ids far apart (layout must not walk the gap). */
+    static StripCase few, fixture, many, sparse;
+    strip_case(&few, 1, 3, 2);
+    strip_case(&many, 1, 64, 40);
+    strip_case(&sparse, 1, 3, 2);
+    for (int ws = WSSET_ID_LIMIT - 4; ws < WSSET_ID_LIMIT; ws++) {
+        wsset_add(&sparse.view, ws);
+        wsset_add(&sparse.all, ws);
+        wsset_set_monitor(&sparse.all, ws, 0);
+    }
+    wsset_init(&fixture.view);
+    wsset_init(&fixture.all);
+    for (int i = 0; i < nw; i++) {
+        wsset_add(&fixture.all, wss[i].id);
+        wsset_set_monitor(&fixture.all, wss[i].id, wss[i].monitor_id);
+        if (wss[i].monitor_id == mons[0].id) wsset_add(&fixture.view, wss[i].id);
+    }
+    fixture.active = mons[0].active_ws;
+
+    DotStrip d;
+    strip_layout(&d, &many.view, &many.all, many.active, &strip_params);
+    if (d.n != MAX_DOTS || !d.more_left || !d.more_right || d.ids[MAX_DOTS / 2] != many.active)
+        die("scrolled strip is not centred on the active workspace");
+
+    const Bench benches[] = {
+        { "json.monitors",        b_monitors,        NULL,     1 },
+        { "json.workspaces",      b_workspaces,      NULL,     1 },
+        { "json.activeworkspace", b_activeworkspace, NULL,     1 },
+        { "json.clients",         b_clients,         NULL,     1 },
+        { "json.batch_snapshot",  b_batch,           NULL,     1 },
+        { "socket2.line",         b_socket2,         NULL,     event_lines },
+        { "palette.parse",        b_palette,         NULL,     1 },
+        { "palette.hex8_to_rgba", b_hex8,            NULL,     1 },
+        { "strip.persistent",     b_strip,           &few,     1 },
+        { "strip.fixture",        b_strip,           &fixture, 1 },
+        { "strip.scrolled",       b_strip,           &many,    1 },
+        { "strip.sparse",         b_strip,           &sparse,  1 },
+    };
+
+    printf("# hotpath-bench fixtures=%s samples=%d\n", dir, samples);
+    bench_columns();
+    for (size_t i = 0; i < sizeof benches / sizeof *benches; i++)
+        if (!bench_run(&benches[i], samples)) die("out of memory");
+
+    s2_reader_free(&s2);
+    return 0;
+}
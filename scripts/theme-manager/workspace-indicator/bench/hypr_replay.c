@@ -0,0 +1,500 @@
+/*
+ * hypr_replay — record Hyprland IPC traffic and serve it back from a fake
+ * instance, so the indicator can run headless and deterministically
+ *
+ *   record <file>     Proxy the live instance ($HYPRLAND_INSTANCE_SIGNATURE)
+ *                     through a fake one named <sig>-rec.  Start the
+ *                     indicator with the printed signature; every socket2
+ *                     line and every request/reply pair it sees is written
+ *                     to <file> with its timestamp.  Ctrl-C to stop.
+ *
+ *   replay <file>     Serve <file> from a fake instance: socket2 clients get
+ *                     the recorded event stream with its original timing,
+ *                     request-socket clients get the recorded reply to the
+ *                     same request (cycling through repeats in order).
+ *       -s SPEED      time scale, 2 = twice as fast, 0 = no delays
+ *       -S SIG        instance signature to create (default "replay")
+ *       -l            loop the event stream
+ *       -x MS         exit MS after the stream ends (default: serve on)
+ *
+ * The fake instance lives in $XDG_RUNTIME_DIR/hypr/<sig>/, the first place
+ * the daemon's find_hypr_socket() looks.  After a replay,
+ * `workspace-indicator ctl stats` gives the event→frame histograms for it.
+ *
+ * File format, length-prefixed so payloads need no escaping:
+ *   E <t_us> <len>\n<bytes>      socket2 line (including its '\n')
+ *   Q <t_us> <len>\n<bytes>      request
+ *   A <t_us> <len>\n<bytes>      reply to the preceding Q
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+enum { MAX_CLIENTS = 16, CHUNK = 65536, REQ_TIMEOUT_MS = 1000 };
+
+static volatile sig_atomic_t quit;
+
+static void on_signal(int sig) { (void)sig; quit = 1; }
+
+static int64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void die(const char *what)
+{
+    perror(what);
+    exit(1);
+}
+
+/* ── Sockets ─────────────────────────────────────────────────────── */
+
+static char *instance_dir(const char *sig)
+{
+    const char *xdg = getenv("XDG_RUNTIME_DIR");
+    char       *dir;
+
+    if (xdg && asprintf(&dir, "%s/hypr/%s", xdg, sig) >= 0) {
+        if (access(dir, F_OK) == 0) return dir;
+        free(dir);
+    }
+    if (asprintf(&dir, "/tmp/hypr/%s", sig) < 0) die("asprintf");
+    return dir;
+}
+
+static int unix_connect(const char *path)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    snprintf(addr.sun_path, sizeof addr.sun_path, "%s", path);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof addr) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int unix_listen(const char *path)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) die("socket");
+
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    snprintf(addr.sun_path, sizeof addr.sun_path, "%s", path);
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof addr) < 0) die(path);
+    if (listen(fd, 8) < 0) die("listen");
+    return fd;
+}
+
+/* Create $XDG_RUNTIME_DIR/hypr/<sig>/ and listen on both sockets in it. */
+static char *fake_instance(const char *sig, int *req_fd, int *ev_fd)
+{
+    const char *xdg = getenv("XDG_RUNTIME_DIR");
+    char       *hypr, *dir, *path;
+
+    if (!xdg) {
+        fprintf(stderr, "hypr-replay: XDG_RUNTIME_DIR is not set\n");
+        exit(1);
+    }
+    if (asprintf(&hypr, "%s/hypr", xdg) < 0 || asprintf(&dir, "%s/%s", hypr, sig) < 0)
+        die("asprintf");
+    mkdir(hypr, 0700);
+    if (mkdir(dir, 0700) < 0 && errno != EEXIST) die(dir);
+    free(hypr);
+
+    if (asprintf(&path, "%s/.socket.sock", dir) < 0) die("asprintf");
+    *req_fd = unix_listen(path);
+    free(path);
+    if (asprintf(&path, "%s/.socket2.sock", dir) < 0) die("asprintf");
+    *ev_fd = unix_listen(path);
+    free(path);
+    return dir;
+}
+
+static void fake_instance_remove(char *dir)
+{
+    char *path;
+    if (asprintf(&path, "%s/.socket.sock", dir) >= 0)  { unlink(path); free(path); }
+    if (asprintf(&path, "%s/.socket2.sock", dir) >= 0) { unlink(path); free(path); }
+    rmdir(dir);
+    free(dir);
+}
+
+static bool write_all(int fd, const char *p, size_t n)
+{
+    while (n > 0) {
+        ssize_t w = write(fd, p, n);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return false;
+        p += w;
+        n -= (size_t)w;
+    }
+    return true;
+}
+
+/* One request as the daemon sends it: a single write, then it waits for EOF. */
+static ssize_t read_request(int fd, char *buf, size_t cap)
+{
+    struct pollfd p = { .fd = fd, .events = POLLIN };
+    if (poll(&p, 1, REQ_TIMEOUT_MS) <= 0) return -1;
+    return read(fd, buf, cap);
+}
+
+/* ── Capture file ────────────────────────────────────────────────── */
+
+typedef struct {
+    char     kind;                    /* 'E', 'Q' or 'A' */
+    int64_t  t_us;
+    char    *data;
+    size_t   len;
+} Record;
+
+static void record_write(FILE *f, char kind, int64_t t_us, const char *data, size_t len)
+{
+    fprintf(f, "%c %lld %zu\n", kind, (long long)t_us, len);
+    fwrite(data, 1, len, f);
+    fflush(f);
+}
+
+static Record *records_load(const char *path, size_t *n_out)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) die(path);
+
+    Record *recs = NULL;
+    size_t  n = 0, cap = 0;
+    char    kind;
+    long long t;
+    size_t  len;
+
+    while (fscanf(f, " %c %lld %zu", &kind, &t, &len) == 3 && fgetc(f) == '\n') {
+        if (n == cap) {
+            cap  = cap ? cap * 2 : 256;
+            recs = realloc(recs, cap * sizeof *recs);
+            if (!recs) die("realloc");
+        }
+        Record *r = &recs[n++];
+        r->kind = kind;
+        r->t_us = t;
+        r->len  = len;
+        r->data = malloc(len + 1);
+        if (!r->data || fread(r->data, 1, len, f) != len) {
+            fprintf(stderr, "hypr-replay: %s: truncated record %zu\n", path, n);
+            exit(1);
+        }
+        r->data[len] = '\0';
+    }
+    fclose(f);
+    *n_out = n;
+    return recs;
+}
+
+/* ── record ──────────────────────────────────────────────────────── */
+
+static int cmd_record(const char *file)
+{
+    const char *sig = getenv("HYPRLAND_INSTANCE_SIGNATURE");
+    if (!sig) {
+        fprintf(stderr, "hypr-replay: HYPRLAND_INSTANCE_SIGNATURE is not set\n");
+        return 1;
+    }
+
+    char *real = instance_dir(sig);
+    char *fake_sig;
+    if (asprintf(&fake_sig, "%s-rec", sig) < 0) die("asprintf");
+
+    int   req_l, ev_l;
+    char *fake = fake_instance(fake_sig, &req_l, &ev_l);
+    FILE *out  = fopen(file, "wb");
+    if (!out) die(file);
+
+    printf("recording to %s; run the indicator with\n"
+           "  HYPRLAND_INSTANCE_SIGNATURE=%s\n", file, fake_sig);
+    fflush(stdout);
+
+    /* socket2 pairs: [i] downstream client, [i] upstream Hyprland */
+    int     down[MAX_CLIENTS], up[MAX_CLIENTS], n_pairs = 0;
+    char   *line[MAX_CLIENTS];
+    size_t  line_len[MAX_CLIENTS];
+    int64_t t0 = now_us();
+    char    buf[CHUNK];
+
+    while (!quit) {
+        struct pollfd p[2 + MAX_CLIENTS];
+        p[0] = (struct pollfd){ .fd = req_l, .events = POLLIN };
+        p[1] = (struct pollfd){ .fd = ev_l,  .events = POLLIN };
+        for (int i = 0; i < n_pairs; i++)
+            p[2 + i] = (struct pollfd){ .fd = up[i], .events = POLLIN };
+
+        if (poll(p, (nfds_t)(2 + n_pairs), -1) < 0) {
+            if (errno == EINTR) continue;
+            die("poll");
+        }
+
+        if (p[0].revents & POLLIN) {
+            int c = accept4(req_l, NULL, NULL, SOCK_CLOEXEC);
+            ssize_t n = c >= 0 ? read_request(c, buf, sizeof buf) : -1;
+            char *sock;
+            if (asprintf(&sock, "%s/.socket.sock", real) < 0) die("asprintf");
+            int u = n > 0 ? unix_connect(sock) : -1;
+            free(sock);
+            if (u >= 0 && write_all(u, buf, (size_t)n)) {
+                record_write(out, 'Q', now_us() - t0, buf, (size_t)n);
+
+                char   *reply = NULL;
+                size_t  rlen = 0;
+                ssize_t r;
+                while ((r = read(u, buf, sizeof buf)) > 0) {
+                    reply = realloc(reply, rlen + (size_t)r);
+                    if (!reply) die("realloc");
+                    memcpy(reply + rlen, buf, (size_t)r);
+                    rlen += (size_t)r;
+                }
+                record_write(out, 'A', now_us() - t0, reply ? reply : "", rlen);
+                write_all(c, reply ? reply : "", rlen);
+                free(reply);
+            }
+            if (u >= 0) close(u);
+            if (c >= 0) close(c);
+        }
+
+        if ((p[1].revents & POLLIN) && n_pairs < MAX_CLIENTS) {
+            int c = accept4(ev_l, NULL, NULL, SOCK_CLOEXEC);
+            char *sock;
+            if (asprintf(&sock, "%s/.socket2.sock", real) < 0) die("asprintf");
+            int u = c >= 0 ? unix_connect(sock) : -1;
+            free(sock);
+            if (u >= 0) {
+                down[n_pairs]     = c;
+                up[n_pairs]       = u;
+                line[n_pairs]     = NULL;
+                line_len[n_pairs] = 0;
+                n_pairs++;
+            } else if (c >= 0) {
+                close(c);
+            }
+        }
+
+        for (int i = n_pairs - 1; i >= 0; i--) {
+            if (!(p[2 + i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+
+            ssize_t n = read(up[i], buf, sizeof buf);
+            if (n > 0 && write_all(down[i], buf, (size_t)n)) {
+                /* Record whole lines, each stamped when its newline arrived. */
+                line[i] = realloc(line[i], line_len[i] + (size_t)n);
+                if (!line[i]) die("realloc");
+                memcpy(line[i] + line_len[i], buf, (size_t)n);
+                line_len[i] += (size_t)n;
+
+                char *s = line[i], *nl;
+                while ((nl = memchr(s, '\n', line_len[i] - (size_t)(s - line[i])))) {
+                    record_write(out, 'E', now_us() - t0, s, (size_t)(nl - s) + 1);
+                    s = nl + 1;
+                }
+                line_len[i] -= (size_t)(s - line[i]);
+                memmove(line[i], s, line_len[i]);
+                continue;
+            }
+
+            close(up[i]);
+            close(down[i]);
+            free(line[i]);
+            n_pairs--;
+            down[i]     = down[n_pairs];
+            up[i]       = up[n_pairs];
+            line[i]     = line[n_pairs];
+            line_len[i] = line_len[n_pairs];
+        }
+    }
+
+    fclose(out);
+    close(req_l);
+    close(ev_l);
+    fake_instance_remove(fake);
+    free(fake_sig);
+    free(real);
+    return 0;
+}
+
+/* ── replay ──────────────────────────────────────────────────────── */
+
+/* Reply to the next unused recording of the same request, cycling. */
+static const Record *find_reply(Record *recs, size_t n, size_t *cursor,
+                                const char *req, size_t len)
+{
+    for (size_t pass = 0; pass < 2; pass++) {
+        for (size_t k = 0; k < n; k++) {
+            size_t i = (*cursor + k) % n;
+            if (recs[i].kind == 'Q' && recs[i].len == len &&
+                memcmp(recs[i].data, req, len) == 0 &&
+                i + 1 < n && recs[i + 1].kind == 'A') {
+                *cursor = i + 2;
+                return &recs[i + 1];
+            }
+        }
+        *cursor = 0;
+    }
+    return NULL;
+}
+
+static int cmd_replay(const char *file, double speed, const char *sig,
+                      bool loop, int exit_ms)
+{
+    size_t  n_recs;
+    Record *recs = records_load(file, &n_recs);
+
+    size_t n_events = 0;
+    for (size_t i = 0; i < n_recs; i++)
+        n_events += recs[i].kind == 'E';
+
+    int   req_l, ev_l;
+    char *fake = fake_instance(sig, &req_l, &ev_l);
+    printf("replaying %zu events from %s; run the indicator with\n"
+           "  HYPRLAND_INSTANCE_SIGNATURE=%s\n", n_events, file, sig);
+    fflush(stdout);
+
+    int     clients[MAX_CLIENTS], n_clients = 0;
+    size_t  next = 0, reply_cursor = 0;       /* next record to stream */
+    int64_t start = -1, base_t = 0, done_at = -1;
+    char    buf[CHUNK];
+
+    while (!quit) {
+        /* Stream every event that is due, then sleep until the next one. */
+        int timeout = -1;
+        while (start >= 0 && next < n_recs) {
+            if (recs[next].kind != 'E') { next++; continue; }
+            int64_t due = speed > 0
+                        ? start + (int64_t)((double)(recs[next].t_us - base_t) / speed)
+                        : now_us();
+            int64_t wait = due - now_us();
+            if (wait > 0) {
+                timeout = (int)((wait + 999) / 1000);
+                break;
+            }
+            for (int i = 0; i < n_clients; i++)
+                write_all(clients[i], recs[next].data, recs[next].len);
+            next++;
+        }
+        if (start >= 0 && next >= n_recs) {
+            if (loop) {
+                next  = 0;
+                start = now_us();
+                continue;
+            }
+            if (done_at < 0) done_at = now_us();
+            if (exit_ms >= 0) {
+                int64_t left = done_at + (int64_t)exit_ms * 1000 - now_us();
+                if (left <= 0) break;
+                timeout = (int)((left + 999) / 1000);
+            }
+        }
+
+        struct pollfd p[2 + MAX_CLIENTS];
+        p[0] = (struct pollfd){ .fd = req_l, .events = POLLIN };
+        p[1] = (struct pollfd){ .fd = ev_l,  .events = POLLIN };
+        for (int i = 0; i < n_clients; i++)
+            p[2 + i] = (struct pollfd){ .fd = clients[i], .events = POLLIN };
+
+        if (poll(p, (nfds_t)(2 + n_clients), timeout) < 0) {
+            if (errno == EINTR) continue;
+            die("poll");
+        }
+
+        if (p[0].revents & POLLIN) {
+            int     c = accept4(req_l, NULL, NULL, SOCK_CLOEXEC);
+            ssize_t n = c >= 0 ? read_request(c, buf, sizeof buf) : -1;
+            if (n > 0) {
+                const Record *a = find_reply(recs, n_recs, &reply_cursor, buf, (size_t)n);
+                if (a) write_all(c, a->data, a->len);
+                else   fprintf(stderr, "hypr-replay: no recorded reply for %.*s\n", (int)n, buf);
+            }
+            if (c >= 0) close(c);
+        }
+
+        if ((p[1].revents & POLLIN) && n_clients < MAX_CLIENTS) {
+            int c = accept4(ev_l, NULL, NULL, SOCK_CLOEXEC);
+            if (c >= 0) clients[n_clients++] = c;
+            /* The stream clock starts with the first subscriber. */
+            if (c >= 0 && start < 0) {
+                start = now_us();
+                for (size_t i = 0; i < n_recs; i++)
+                    if (recs[i].kind == 'E') { base_t = recs[i].t_us; break; }
+            }
+        }
+
+        for (int i = n_clients - 1; i >= 0; i--) {
+            if (!(p[2 + i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            if (read(clients[i], buf, sizeof buf) > 0) continue;
+            close(clients[i]);
+            clients[i] = clients[--n_clients];
+        }
+    }
+
+    for (int i = 0; i < n_clients; i++) close(clients[i]);
+    close(req_l);
+    close(ev_l);
+    fake_instance_remove(fake);
+    for (size_t i = 0; i < n_recs; i++) free(recs[i].data);
+    free(recs);
+    return 0;
+}
+
+/* ── main ────────────────────────────────────────────────────────── */
+
+static int usage(void)
+{
+    fprintf(stderr,
+            "usage: hypr-replay record <file>\n"
+            "       hypr-replay replay <file> [-s speed] [-S sig] [-l] [-x ms]\n");
+    return 2;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3) return usage();
+
+    struct sigaction sa = { .sa_handler = on_signal };
+    sigaction(SIGINT,  &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);         /* a client hanging up is not fatal */
+
+    if (strcmp(argv[1], "record") == 0)
+        return cmd_record(argv[2]);
+    if (strcmp(argv[1], "replay") != 0)
+        return usage();
+
+    double      speed   = 1.0;
+    const char *sig     = "replay";
+    bool        loop    = false;
+    int         exit_ms = -1;
+    int         opt;
+
+    optind = 3;
+    while ((opt = getopt(argc, argv, "s:S:lx:")) != -1) {
+        switch (opt) {
+        case 's': speed   = atof(optarg); break;
+        case 'S': sig     = optarg;       break;
+        case 'l': loop    = true;         break;
+        case 'x': exit_ms = atoi(optarg); break;
+        default:  return usage();
+        }
+    }
+    return cmd_replay(argv[2], speed, sig, loop, exit_ms);
+}
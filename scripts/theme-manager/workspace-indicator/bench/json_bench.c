@@ -0,0 +1,281 @@
+/*
+ * json_bench — single-pass json.c reader vs. the strstr helpers it replaced
+ *
+ * Synthesises `workspaces -j` / `monitors -j` replies shaped like the real
+ * thing (window titles with escapes, nested workspace refs) and times both
+ * parsers on them.  The reference implementation is the pre-tokenizer code
+ * from main.c with g_strndup swapped for strndup so this builds without GLib.
+ *
+ * Usage: bench/json-bench [workspaces] [monitors] [iterations]
+ */
+
+#define _GNU_SOURCE
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../json.h"
+
+enum { MAX_WS = 10, MAX_OBJS = 1024 };
+
+/* ── Fixtures ────────────────────────────────────────────────────── */
+
+static char *make_workspaces(int n_ws, int n_mon)
+{
+    size_t cap = (size_t)n_ws * 512 + 16, len = 0;
+    char  *js  = malloc(cap);
+
+    len += (size_t)snprintf(js + len, cap - len, "[");
+    for (int i = 1; i <= n_ws; i++) {
+        len += (size_t)snprintf(js + len, cap - len,
+            "%s{\n    \"id\": %d,\n    \"name\": \"%d\",\n"
+            "    \"monitor\": \"DP-%d\",\n    \"monitorID\": %d,\n"
+            "    \"windows\": %d,\n    \"hasfullscreen\": false,\n"
+            "    \"lastwindow\": \"0x5a3c%04x\",\n"
+            "    \"lastwindowtitle\": \"nvim \\\"main.c\\\" {\\\"id\\\": 99} \\u00e9 \\\\ ~/src\"\n}",
+            i > 1 ? "," : "", i, i, (i % n_mon) + 1, i % n_mon, i % 7, i);
+    }
+    len += (size_t)snprintf(js + len, cap - len, "]");
+    return js;
+}
+
+static char *make_monitors(int n_mon)
+{
+    size_t cap = (size_t)n_mon * 1024 + 16, len = 0;
+    char  *js  = malloc(cap);
+
+    len += (size_t)snprintf(js + len, cap - len, "[");
+    for (int i = 0; i < n_mon; i++) {
+        len += (size_t)snprintf(js + len, cap - len,
+            "%s{\n    \"id\": %d,\n    \"name\": \"DP-%d\",\n"
+            "    \"description\": \"Dell Inc. DELL U2720Q 7XK2%03d\",\n"
+            "    \"make\": \"Dell Inc.\",\n    \"model\": \"DELL U2720Q\",\n"
+            "    \"serial\": \"7XK2%03d\",\n    \"width\": 3840,\n    \"height\": 2160,\n"
+            "    \"refreshRate\": 59.99700,\n    \"x\": %d,\n    \"y\": 0,\n"
+            "    \"activeWorkspace\": {\n        \"id\": %d,\n        \"name\": \"%d\"\n    },\n"
+            "    \"specialWorkspace\": {\n        \"id\": 0,\n        \"name\": \"\"\n    },\n"
+            "    \"reserved\": [0, 0, 0, 0],\n    \"scale\": 1.50,\n    \"transform\": 0,\n"
+            "    \"focused\": %s,\n    \"dpmsStatus\": true,\n    \"vrr\": false,\n"
+            "    \"availableModes\": [\"3840x2160@60.00Hz\",\"2560x1440@59.95Hz\"]\n}",
+            i ? "," : "", i, i + 1, i, i, i * 3840, i + 1, i + 1,
+            i == n_mon - 1 ? "true" : "false");
+    }
+    len += (size_t)snprintf(js + len, cap - len, "]");
+    return js;
+}
+
+/* ── Reference: previous strstr helpers ──────────────────────────── */
+
+typedef struct {
+    char name[128];
+    int  id;
+    int  x, y, width, height;
+    char make[128];
+    char model[128];
+    int  active_ws;
+    bool focused;
+} RefMonitor;
+
+static int ref_first_id(const char *js)
+{
+    const char *p = strstr(js, "\"id\":");
+    if (!p) return -1;
+    p += 5;
+    while (*p == ' ') p++;
+    return atoi(p);
+}
+
+static bool ref_key_int(const char *js, const char *key, int *out)
+{
+    const char *p = strstr(js, key);
+    if (!p) return false;
+    p += strlen(key);
+    while (*p == ' ' || *p == '\n') p++;
+    *out = atoi(p);
+    return true;
+}
+
+static bool ref_key_bool(const char *js, const char *key, bool *out)
+{
+    const char *p = strstr(js, key);
+    if (!p) return false;
+    p += strlen(key);
+    while (*p == ' ' || *p == '\n') p++;
+    if (strncmp(p, "true", 4) == 0)  { *out = true;  return true; }
+    if (strncmp(p, "false", 5) == 0) { *out = false; return true; }
+    return false;
+}
+
+static bool ref_key_string(const char *js, const char *key, char *out, size_t out_sz)
+{
+    const char *p = strstr(js, key);
+    if (!p) return false;
+    p += strlen(key);
+    while (*p == ' ' || *p == '\n') p++;
+    if (*p != '"') return false;
+    p++;
+    const char *end = strchr(p, '"');
+    if (!end) return false;
+    size_t n = (size_t)(end - p) < out_sz - 1 ? (size_t)(end - p) : out_sz - 1;
+    memcpy(out, p, n);
+    out[n] = '\0';
+    return true;
+}
+
+static void ref_foreach_object(const char *js, void (*fn)(const char *, void *), void *data)
+{
+    const char *obj = NULL;
+    int depth = 0;
+    for (const char *p = js; *p; p++) {
+        if (*p == '{') {
+            if (depth == 0) obj = p;
+            depth++;
+            continue;
+        }
+        if (*p != '}') continue;
+        depth--;
+        if (depth != 0 || !obj) continue;
+        char *chunk = strndup(obj, (size_t)(p - obj + 1));
+        fn(chunk, data);
+        free(chunk);
+        obj = NULL;
+    }
+}
+
+typedef struct { RefMonitor m[16]; int n; } RefMonitors;
+typedef struct { int id[MAX_OBJS]; int mon[MAX_OBJS]; int n; } RefWorkspaces;
+
+static void ref_monitor(const char *obj, void *data)
+{
+    RefMonitors *out = data;
+    if (out->n >= 16) return;
+    RefMonitor m = { .active_ws = -1 };
+    if (!ref_key_string(obj, "\"name\":", m.name, sizeof m.name)) return;
+    m.id = ref_first_id(obj);
+    ref_key_int(obj, "\"x\":", &m.x);
+    ref_key_int(obj, "\"y\":", &m.y);
+    ref_key_int(obj, "\"width\":", &m.width);
+    ref_key_int(obj, "\"height\":", &m.height);
+    ref_key_string(obj, "\"make\":", m.make, sizeof m.make);
+    ref_key_string(obj, "\"model\":", m.model, sizeof m.model);
+    const char *aw = strstr(obj, "\"activeWorkspace\":");
+    if (aw) m.active_ws = ref_first_id(aw);
+    ref_key_bool(obj, "\"focused\":", &m.focused);
+    out->m[out->n++] = m;
+}
+
+static void ref_workspace(const char *obj, void *data)
+{
+    RefWorkspaces *out = data;
+    int id = ref_first_id(obj);
+    if (id < 1 || out->n >= MAX_OBJS) return;
+    int mon = -1;
+    ref_key_int(obj, "\"monitorID\":", &mon);
+    out->id[out->n]  = id;
+    out->mon[out->n] = mon;
+    out->n++;
+}
+
+/* ── Timing ──────────────────────────────────────────────────────── */
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static volatile int sink;
+
+int main(int argc, char **argv)
+{
+    int n_ws  = argc > 1 ? atoi(argv[1]) : 100;
+    int n_mon = argc > 2 ? atoi(argv[2]) : 4;
+    int iters = argc > 3 ? atoi(argv[3]) : 20000;
+    if (n_ws < 1 || n_ws > MAX_OBJS || n_mon < 1 || n_mon > 16 || iters < 1) {
+        fprintf(stderr, "usage: %s [workspaces 1-%d] [monitors 1-16] [iterations]\n",
+                argv[0], MAX_OBJS);
+        return 2;
+    }
+
+    char  *wj = make_workspaces(n_ws, n_mon);
+    char  *mj = make_monitors(n_mon);
+    size_t wl = strlen(wj), ml = strlen(mj);
+
+    /* Cross-check before timing: both readers must agree on the fields. */
+    static HyprWorkspace ws[MAX_OBJS];
+    static HyprMonitor   mons[16];
+    static RefWorkspaces rws;
+    static RefMonitors   rms;
+    JsonCursor c;
+
+    json_cursor_init(&c, wj, wl);
+    int nw = json_parse_workspaces(&c, ws, MAX_OBJS);
+    json_cursor_init(&c, mj, ml);
+    int nm = json_parse_monitors(&c, mons, 16);
+    ref_foreach_object(wj, ref_workspace, &rws);
+    ref_foreach_object(mj, ref_monitor, &rms);
+
+    if (nw != n_ws || nm != n_mon || rms.n != n_mon) {
+        fprintf(stderr, "json-bench: parse count mismatch (ws %d, mon %d/%d)\n", nw, nm, rms.n);
+        return 1;
+    }
+    for (int i = 0; i < nw; i++) {
+        if (ws[i].id != i + 1 || ws[i].monitor_id != (i + 1) % n_mon) {
+            fprintf(stderr, "json-bench: workspace %d mismatch\n", i + 1);
+            return 1;
+        }
+    }
+    for (int i = 0; i < nm; i++) {
+        if (mons[i].id != rms.m[i].id || mons[i].active_ws != rms.m[i].active_ws ||
+            mons[i].focused != rms.m[i].focused || mons[i].x != rms.m[i].x ||
+            strcmp(mons[i].name, rms.m[i].name) != 0 ||
+            strcmp(mons[i].model, rms.m[i].model) != 0) {
+            fprintf(stderr, "json-bench: monitor %d mismatch\n", i);
+            return 1;
+        }
+    }
+
+    printf("json-bench: %d workspaces (%zu B), %d monitors (%zu B), %d iterations\n",
+           n_ws, wl, n_mon, ml, iters);
+
+    double t0 = now_ns();
+    for (int i = 0; i < iters; i++) {
+        rws.n = 0;
+        ref_foreach_object(wj, ref_workspace, &rws);
+        sink += rws.n;
+    }
+    double ref_ws = (now_ns() - t0) / iters;
+
+    t0 = now_ns();
+    for (int i = 0; i < iters; i++) {
+        json_cursor_init(&c, wj, wl);
+        sink += json_parse_workspaces(&c, ws, MAX_OBJS);
+    }
+    double new_ws = (now_ns() - t0) / iters;
+
+    t0 = now_ns();
+    for (int i = 0; i < iters; i++) {
+        rms.n = 0;
+        ref_foreach_object(mj, ref_monitor, &rms);
+        sink += rms.n;
+    }
+    double ref_mon = (now_ns() - t0) / iters;
+
+    t0 = now_ns();
+    for (int i = 0; i < iters; i++) {
+        json_cursor_init(&c, mj, ml);
+        sink += json_parse_monitors(&c, mons, 16);
+    }
+    double new_mon = (now_ns() - t0) / iters;
+
+    printf("%-12s %14s %14s %9s\n", "reply", "strstr ns/op", "single ns/op", "speedup");
+    printf("%-12s %14.0f %14.0f %8.1fx\n", "workspaces", ref_ws,  new_ws,  ref_ws / new_ws);
+    printf("%-12s %14.0f %14.0f %8.1fx\n", "monitors",   ref_mon, new_mon, ref_mon / new_mon);
+
+    free(wj);
+    free(mj);
+    return 0;
+}
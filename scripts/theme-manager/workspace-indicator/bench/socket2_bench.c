@@ -0,0 +1,243 @@
+/*
+ * socket2_bench — socket2.c splitter/dispatch vs. the byte-copy reader it replaced
+ *
+ * Replays a socket2 stream through both readers in read()-sized chunks and
+ * reports events/sec.  Without an argument the stream is synthesised to
+ * look like a terminal spamming window titles (activewindow/windowtitle
+ * churn, a few multi-KiB titles, the odd workspace switch); with a path it
+ * replays that capture instead.
+ *
+ * Usage: bench/socket2-bench [stream-file] [iterations]
+ */
+
+#define _GNU_SOURCE
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../socket2.h"
+
+enum { BUF_SZ = 4096, CHUNK = 4096 };
+
+/* ── Stream ──────────────────────────────────────────────────────── */
+
+typedef struct {
+    char  *data;
+    size_t len, cap;
+} Buf;
+
+static void put(Buf *b, const char *s, size_t n)
+{
+    if (b->len + n > b->cap) {
+        b->cap  = (b->len + n) * 2;
+        b->data = realloc(b->data, b->cap);
+    }
+    memcpy(b->data + b->len, s, n);
+    b->len += n;
+}
+
+static void putf(Buf *b, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+static void putf(Buf *b, const char *fmt, ...)
+{
+    char    tmp[512];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(tmp, sizeof tmp, fmt, ap);
+    va_end(ap);
+    put(b, tmp, (size_t)n);
+}
+
+static Buf synth_stream(void)
+{
+    Buf  b = {0};
+    char big[9000];
+    memset(big, 'x', sizeof big);
+
+    for (int i = 0; i < 20000; i++) {
+        unsigned w = 0x55d0c000u + (unsigned)(i % 13);
+        putf(&b, "activewindow>>kitty,nvim src/main.c (%d) - ~/dotfiles\n", i);
+        putf(&b, "activewindowv2>>%x\n", w);
+        putf(&b, "windowtitle>>%x\n", w);
+        putf(&b, "windowtitlev2>>%x,cargo build --release [%d/%d] Compiling crate-%d\n",
+             w, i % 400, 400, i);
+        if (i % 50 == 0) {
+            putf(&b, "windowtitlev2>>%x,", w);
+            put(&b, big, sizeof big);          /* longer than BUF_SZ */
+            put(&b, "\n", 1);
+        }
+        if (i % 100 == 0) {
+            int ws = i / 100 % 9 + 1;
+            putf(&b, "workspace>>%d\nworkspacev2>>%d,%d\n", ws, ws, ws);
+            putf(&b, "focusedmon>>DP-%d,%d\n", ws % 2 + 1, ws);
+        }
+        if (i % 400 == 0)
+            putf(&b, "movewindow>>%x,3\nmovewindowv2>>%x,3,3\n", w, w);
+    }
+    return b;
+}
+
+static Buf load_stream(const char *path)
+{
+    Buf   b = {0};
+    FILE *f = fopen(path, "rb");
+    if (!f) { perror(path); exit(2); }
+
+    char   tmp[65536];
+    size_t n;
+    while ((n = fread(tmp, 1, sizeof tmp, f)) > 0)
+        put(&b, tmp, n);
+    fclose(f);
+    return b;
+}
+
+/* ── Reference: previous byte-copy reader ────────────────────────── */
+
+static const char *const ref_events[] = {
+    "workspacev2>>",
+    "createworkspacev2>>",
+    "destroyworkspacev2>>",
+    "focusedmon>>",
+    "moveworkspacev2>>",
+    "monitoraddedv2>>",
+    "monitorremoved>>",
+};
+
+static unsigned long ref_hits;
+
+static void ref_run(const char *data, size_t len)
+{
+    char   line[BUF_SZ];
+    size_t llen = 0;
+
+    for (size_t off = 0; off < len; off += CHUNK) {
+        char   buf[CHUNK];
+        size_t n = len - off < CHUNK ? len - off : CHUNK;
+        memcpy(buf, data + off, n);               /* stands in for read() */
+
+        for (size_t i = 0; i < n; i++) {
+            if (buf[i] == '\n') {
+                line[llen] = '\0';
+                for (size_t e = 0; e < sizeof ref_events / sizeof *ref_events; e++) {
+                    if (strncmp(line, ref_events[e], strlen(ref_events[e])) == 0) {
+                        ref_hits++;
+                        break;
+                    }
+                }
+                llen = 0;
+            } else if (llen < sizeof line - 1) {
+                line[llen++] = buf[i];
+            }
+        }
+    }
+}
+
+/* ── socket2.c reader ────────────────────────────────────────────── */
+
+static unsigned long new_hits;
+static size_t        new_longest;
+
+static void count(char *payload, size_t len, void *user)
+{
+    (void)payload; (void)user;
+    new_hits++;
+    if (len > new_longest) new_longest = len;
+}
+
+static const S2Event events[] = {
+    S2_EVENT("workspacev2",        count),
+    S2_EVENT("createworkspacev2",  count),
+    S2_EVENT("destroyworkspacev2", count),
+    S2_EVENT("focusedmon",         count),
+    S2_EVENT("moveworkspacev2",    count),
+    S2_EVENT("monitoraddedv2",     count),
+    S2_EVENT("monitorremoved",     count),
+};
+
+static void new_run(S2Reader *r, const char *data, size_t len)
+{
+    for (size_t off = 0; off < len; ) {
+        size_t avail;
+        char  *dst = s2_reader_space(r, &avail);
+        size_t n   = len - off;
+        if (n > avail) n = avail;
+        if (n > CHUNK) n = CHUNK;
+        memcpy(dst, data + off, n);               /* stands in for read() */
+        s2_reader_commit(r, n);
+        off += n;
+    }
+}
+
+/* ── Timing ──────────────────────────────────────────────────────── */
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv)
+{
+    Buf stream = argc > 1 && argv[1][0] ? load_stream(argv[1]) : synth_stream();
+    int iters  = argc > 2 ? atoi(argv[2]) : 20;
+    if (iters < 1) iters = 1;
+
+    size_t lines = 0;
+    for (size_t i = 0; i < stream.len; i++)
+        lines += stream.data[i] == '\n';
+
+    S2Reader r;
+    s2_reader_init(&r, events, sizeof events / sizeof *events, BUF_SZ, NULL);
+
+    /* Sanity: both readers must agree on what reaches a handler. */
+    ref_run(stream.data, stream.len);
+    new_run(&r, stream.data, stream.len);
+    if (ref_hits != new_hits) {
+        fprintf(stderr, "socket2-bench: dispatch mismatch (ref %lu, new %lu)\n",
+                ref_hits, new_hits);
+        return 1;
+    }
+    /* A handled event longer than the initial buffer must arrive whole. */
+    {
+        S2Reader lr;
+        char     big[3 * BUF_SZ];
+        memset(big, 'm', sizeof big);
+        s2_reader_init(&lr, events, sizeof events / sizeof *events, BUF_SZ, NULL);
+        s2_reader_feed(&lr, "monitoraddedv2>>", 16);
+        s2_reader_feed(&lr, big, sizeof big);
+        s2_reader_feed(&lr, "\n", 1);
+        s2_reader_free(&lr);
+        if (new_longest != sizeof big) {
+            fprintf(stderr, "socket2-bench: long event truncated to %zu of %zu bytes\n",
+                    new_longest, sizeof big);
+            return 1;
+        }
+        new_hits--;
+    }
+
+    printf("socket2-bench: %zu lines (%.1f MiB), %lu handled, %d iterations\n",
+           lines, stream.len / 1048576.0, new_hits, iters);
+
+    double t0 = now_s();
+    for (int i = 0; i < iters; i++)
+        ref_run(stream.data, stream.len);
+    double ref_t = (now_s() - t0) / iters;
+
+    t0 = now_s();
+    for (int i = 0; i < iters; i++)
+        new_run(&r, stream.data, stream.len);
+    double new_t = (now_s() - t0) / iters;
+
+    printf("%-10s %14s %10s\n", "reader", "events/s", "MiB/s");
+    printf("%-10s %14.0f %10.1f\n", "byte-copy", lines / ref_t, stream.len / 1048576.0 / ref_t);
+    printf("%-10s %14.0f %10.1f\n", "socket2.c", lines / new_t, stream.len / 1048576.0 / new_t);
+    printf("speedup    %13.1fx\n", ref_t / new_t);
+
+    s2_reader_free(&r);
+    free(stream.data);
+    return 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * benchrun.c — median/MAD timing loop (see benchrun.h)
+ */
+
+#define _GNU_SOURCE
+#include "benchrun.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+enum { SAMPLE_NS = 1000000 };         /* target duration of one sample */
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double median(double *v, int n)
+{
+    qsort(v, (size_t)n, sizeof *v, cmp_double);
+    return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+}
+
+void bench_columns(void)
+{
+    printf("bench\tmedian_ns\tmad_ns\tmad_pct\tsamples\tops_per_sample\n");
+}
+
+bool bench_run(const Bench *b, int samples)
+{
+    /* Calibrate: double the batch until one sample takes SAMPLE_NS. */
+    long iters = 1;
+    for (;;) {
+        double t0 = now_ns();
+        for (long i = 0; i < iters; i++) b->fn(b->ctx);
+        if (now_ns() - t0 >= SAMPLE_NS || iters >= 1L << 30) break;
+        iters *= 2;
+    }
+
+    double *ns  = malloc((size_t)samples * sizeof *ns);
+    double *dev = malloc((size_t)samples * sizeof *dev);
+    if (!ns || !dev) {
+        free(ns);
+        free(dev);
+        return false;
+    }
+
+    for (int s = 0; s < samples; s++) {
+        double t0 = now_ns();
+        for (long i = 0; i < iters; i++) b->fn(b->ctx);
+        ns[s] = (now_ns() - t0) / (double)iters / (double)b->units;
+    }
+
+    double med = median(ns, samples);
+    for (int s = 0; s < samples; s++)
+        dev[s] = ns[s] > med ? ns[s] - med : med - ns[s];
+    double mad = median(dev, samples);
+
+    printf("%s\t%.1f\t%.1f\t%.1f\t%d\t%ld\n", b->name, med, mad,
+           med > 0 ? mad / med * 100 : 0, samples, iters * (long)b->units);
+    fflush(stdout);
+    free(ns);
+    free(dev);
+    return true;
+}
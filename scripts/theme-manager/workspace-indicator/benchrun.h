@@ -0,0 +1,32 @@
+/*
+ * benchrun.h — calibrated median/MAD timing loop shared by the benchmarks
+ *
+ * bench/hotpath-bench (parsers, dispatch, layout) and the daemon's
+ * `--render-bench` (model update, drawing) both report through this, so
+ * their rows share one TSV schema and can be concatenated and diffed:
+ *
+ *   bench  median_ns  mad_ns  mad_pct  samples  ops_per_sample
+ *
+ * Each benchmark is calibrated to ~1 ms per sample; ns are per unit.
+ */
+
+#ifndef WI_BENCHRUN_H
+#define WI_BENCHRUN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct {
+    const char *name;
+    void      (*fn)(void *ctx);
+    void       *ctx;
+    size_t      units;                /* ops per call: ns are per unit */
+} Bench;
+
+/* The column header line. */
+void bench_columns(void);
+
+/* Calibrate, sample and print one row; false if out of memory. */
+bool bench_run(const Bench *b, int samples);
+
+#endif /* WI_BENCHRUN_H */
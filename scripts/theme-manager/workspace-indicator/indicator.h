@@ -0,0 +1,39 @@
+/*
+ * indicator.h — tunables and socket2 event table shared with the benches
+ *
+ * bench/hotpath-bench includes this instead of copying main.c's limits
+ * and handler list, so the paths it times cannot drift from the ones the
+ * daemon runs.  Tunables that only the daemon uses stay in main.c.
+ */
+
+#ifndef WI_INDICATOR_H
+#define WI_INDICATOR_H
+
+enum {
+    PERSISTENT_WS  = 5,       /* always-visible workspace slots        */
+    MAX_DOTS       = 10,      /* dots shown at once; more scroll       */
+    MAX_MONS       = 16,      /* tracked outputs                       */
+    MAX_CLIENTS    = 1024,    /* windows read per seed                 */
+    WIN_STEPS      = 4,       /* window counts past this look the same */
+    BUF_SZ         = 4096,    /* initial socket2 line buffer           */
+};
+
+/*
+ * The socket2 events the daemon handles, as X(name, handler) entries
+ * separated by commas; `{ WI_IPC_EVENTS(S2_EVENT) }` is the dispatch
+ * table.  Everything not listed is dropped by the reader without a copy.
+ */
+#define WI_IPC_EVENTS(X)                               \
+    X("workspacev2",        ev_workspacev2),           \
+    X("createworkspacev2",  ev_createworkspacev2),     \
+    X("destroyworkspacev2", ev_destroyworkspacev2),    \
+    X("focusedmon",         ev_focusedmon),            \
+    X("moveworkspacev2",    ev_moveworkspacev2),       \
+    X("monitoraddedv2",     ev_monitoraddedv2),        \
+    X("monitorremoved",     ev_monitorremoved),        \
+    X("renameworkspace",    ev_renameworkspace),       \
+    X("openwindow",         ev_openwindow),            \
+    X("closewindow",        ev_closewindow),           \
+    X("movewindowv2",       ev_movewindowv2)
+
+#endif /* WI_INDICATOR_H */
@@ -0,0 +1,402 @@
+/*
+ * json.c — single-pass reader for Hyprland `-j` replies (see json.h)
+ */
+
+#include "json.h"
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    const char *s;
+    size_t      len;
+} JsonSpan;
+
+#define KEY_IS(k, lit) \
+    ((k).len == sizeof(lit) - 1 && memcmp((k).s, (lit), sizeof(lit) - 1) == 0)
+
+void json_cursor_init(JsonCursor *c, const char *js, size_t len)
+{
+    c->p   = js;
+    c->end = js + len;
+}
+
+/* ── Lexical helpers ─────────────────────────────────────────────── */
+
+static void skip_ws(JsonCursor *c)
+{
+    while (c->p < c->end &&
+           (*c->p == ' ' || *c->p == '\n' || *c->p == '\r' || *c->p == '\t'))
+        c->p++;
+}
+
+static bool expect(JsonCursor *c, char ch)
+{
+    skip_ws(c);
+    if (c->p >= c->end || *c->p != ch) return false;
+    c->p++;
+    return true;
+}
+
+/* Cursor on the opening quote; leaves it past the closing one. */
+static bool skip_string(JsonCursor *c)
+{
+    const char *p = c->p + 1;
+    while (p < c->end) {
+        const char *q = memchr(p, '"', (size_t)(c->end - p));
+        if (!q) break;
+
+        /* A quote is escaped iff an odd run of backslashes precedes it. */
+        const char *b = q;
+        while (b > p && b[-1] == '\\') b--;
+        if (((q - b) & 1) == 0) {
+            c->p = q + 1;
+            return true;
+        }
+        p = q + 1;
+    }
+    c->p = c->end;
+    return false;
+}
+
+/* Key spans are compared raw; Hyprland keys never carry escapes. */
+static bool read_key(JsonCursor *c, JsonSpan *key)
+{
+    skip_ws(c);
+    if (c->p >= c->end || *c->p != '"') return false;
+
+    const char *start = c->p + 1;
+    if (!skip_string(c)) return false;
+    key->s   = start;
+    key->len = (size_t)(c->p - 1 - start);
+    return expect(c, ':');
+}
+
+static int hex4(const char *p)
+{
+    int v = 0;
+    for (int i = 0; i < 4; i++) {
+        char ch = p[i];
+        v <<= 4;
+        if      (ch >= '0' && ch <= '9') v |= ch - '0';
+        else if (ch >= 'a' && ch <= 'f') v |= ch - 'a' + 10;
+        else if (ch >= 'A' && ch <= 'F') v |= ch - 'A' + 10;
+        else return -1;
+    }
+    return v;
+}
+
+static size_t put_utf8(char *out, unsigned cp)
+{
+    if (cp < 0x80) {
+        out[0] = (char)cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = (char)(0xC0 | (cp >> 6));
+        out[1] = (char)(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = (char)(0xE0 | (cp >> 12));
+        out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (cp >> 18));
+    out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+/*
+ * Decode a string value into out (always NUL-terminated, truncated to
+ * out_sz).  The cursor still advances over the whole string.
+ */
+static bool read_string(JsonCursor *c, char *out, size_t out_sz)
+{
+    skip_ws(c);
+    if (c->p >= c->end || *c->p != '"') return false;
+
+    const char *p = c->p + 1;
+    size_t      n = 0;
+
+    while (p < c->end && *p != '"') {
+        char   tmp[4];
+        size_t tlen = 1;
+
+        if (*p != '\\') {
+            tmp[0] = *p++;
+        } else {
+            if (p + 1 >= c->end) break;
+            char e = p[1];
+            p += 2;
+            switch (e) {
+            case 'b': tmp[0] = '\b'; break;
+            case 'f': tmp[0] = '\f'; break;
+            case 'n': tmp[0] = '\n'; break;
+            case 'r': tmp[0] = '\r'; break;
+            case 't': tmp[0] = '\t'; break;
+            case 'u': {
+                int cp = (p + 4 <= c->end) ? hex4(p) : -1;
+                if (cp < 0) { tmp[0] = '?'; break; }
+                p += 4;
+                if (cp >= 0xD800 && cp < 0xDC00 && p + 6 <= c->end &&
+                    p[0] == '\\' && p[1] == 'u') {
+                    int lo = hex4(p + 2);
+                    if (lo >= 0xDC00 && lo < 0xE000) {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                        p += 6;
+                    }
+                }
+                tlen = put_utf8(tmp, (unsigned)cp);
+                break;
+            }
+            default:  tmp[0] = e; break;     /* \" \\ \/ */
+            }
+        }
+
+        if (out_sz && n + tlen < out_sz) {
+            memcpy(out + n, tmp, tlen);
+            n += tlen;
+        }
+    }
+
+    if (out_sz) out[n] = '\0';
+    if (p >= c->end) { c->p = c->end; return false; }
+    c->p = p + 1;
+    return true;
+}
+
+/* Integer part of a number; fraction and exponent are consumed and dropped. */
+static bool read_int(JsonCursor *c, int *out)
+{
+    skip_ws(c);
+    const char *p   = c->p;
+    bool        neg = false;
+
+    if (p < c->end && *p == '-') { neg = true; p++; }
+    if (p >= c->end || *p < '0' || *p > '9') return false;
+
+    long v = 0;
+    while (p < c->end && *p >= '0' && *p <= '9') {
+        if (v < INT_MAX) v = v * 10 + (*p - '0');
+        p++;
+    }
+    while (p < c->end && (*p == '.' || *p == 'e' || *p == 'E' ||
+                          *p == '+' || *p == '-' || (*p >= '0' && *p <= '9')))
+        p++;
+
+    if (v > INT_MAX) v = INT_MAX;
+    *out = (int)(neg ? -v : v);
+    c->p = p;
+    return true;
+}
+
+static bool read_bool(JsonCursor *c, bool *out)
+{
+    skip_ws(c);
+    size_t left = (size_t)(c->end - c->p);
+    if (left >= 4 && memcmp(c->p, "true", 4) == 0)  { *out = true;  c->p += 4; return true; }
+    if (left >= 5 && memcmp(c->p, "false", 5) == 0) { *out = false; c->p += 5; return true; }
+    return false;
+}
+
+static bool skip_value(JsonCursor *c)
+{
+    skip_ws(c);
+    if (c->p >= c->end) return false;
+
+    char ch = *c->p;
+    if (ch == '"') return skip_string(c);
+
+    if (ch == '{' || ch == '[') {
+        int depth = 0;
+        while (c->p < c->end) {
+            ch = *c->p;
+            if (ch == '"') {
+                if (!skip_string(c)) return false;
+                continue;
+            }
+            c->p++;
+            if (ch == '{' || ch == '[')
+                depth++;
+            else if ((ch == '}' || ch == ']') && --depth == 0)
+                return true;
+        }
+        return false;
+    }
+
+    /* number / true / false / null */
+    const char *start = c->p;
+    while (c->p < c->end && *c->p != ',' && *c->p != '}' && *c->p != ']' &&
+           *c->p != ' ' && *c->p != '\n' && *c->p != '\r' && *c->p != '\t')
+        c->p++;
+    return c->p > start;
+}
+
+/*
+ * Container iteration.  Both return 1 when another member follows (for
+ * objects, with its key read and the ':' consumed), 0 at the closing
+ * bracket and -1 on malformed input.
+ */
+static int object_next(JsonCursor *c, JsonSpan *key)
+{
+    skip_ws(c);
+    if (c->p < c->end && *c->p == ',') { c->p++; skip_ws(c); }
+    if (c->p >= c->end) return -1;
+    if (*c->p == '}') { c->p++; return 0; }
+    return read_key(c, key) ? 1 : -1;
+}
+
+static int array_next(JsonCursor *c)
+{
+    skip_ws(c);
+    if (c->p < c->end && *c->p == ',') { c->p++; skip_ws(c); }
+    if (c->p >= c->end) return -1;
+    if (*c->p == ']') { c->p++; return 0; }
+    return 1;
+}
+
+/* ── Hyprland objects ────────────────────────────────────────────── */
+
+/* {"id": N, ...} nested object — only the id is of interest. */
+static bool parse_ws_ref(JsonCursor *c, int *id)
+{
+    if (!expect(c, '{')) return false;
+
+    JsonSpan k;
+    int      r;
+    while ((r = object_next(c, &k)) > 0) {
+        bool ok = KEY_IS(k, "id") ? read_int(c, id) : skip_value(c);
+        if (!ok) return false;
+    }
+    return r == 0;
+}
+
+static bool parse_monitor(JsonCursor *c, HyprMonitor *m)
+{
+    if (!expect(c, '{')) return false;
+
+    memset(m, 0, sizeof *m);
+    m->active_ws = -1;
+
+    JsonSpan k;
+    int      r;
+    while ((r = object_next(c, &k)) > 0) {
+        bool ok;
+        if      (KEY_IS(k, "id"))              ok = read_int(c, &m->id);
+        else if (KEY_IS(k, "name"))            ok = read_string(c, m->name,  sizeof m->name);
+        else if (KEY_IS(k, "make"))            ok = read_string(c, m->make,  sizeof m->make);
+        else if (KEY_IS(k, "model"))           ok = read_string(c, m->model, sizeof m->model);
+        else if (KEY_IS(k, "x"))               ok = read_int(c, &m->x);
+        else if (KEY_IS(k, "y"))               ok = read_int(c, &m->y);
+        else if (KEY_IS(k, "width"))           ok = read_int(c, &m->width);
+        else if (KEY_IS(k, "height"))          ok = read_int(c, &m->height);
+        else if (KEY_IS(k, "activeWorkspace")) ok = parse_ws_ref(c, &m->active_ws);
+        else if (KEY_IS(k, "focused"))         ok = read_bool(c, &m->focused);
+        else                                   ok = skip_value(c);
+        if (!ok) return false;
+    }
+    return r == 0;
+}
+
+bool json_parse_workspace(JsonCursor *c, HyprWorkspace *w)
+{
+    if (!expect(c, '{')) return false;
+
+    w->id         = -1;
+    w->monitor_id = -1;
+    w->name[0]    = '\0';
+
+    JsonSpan k;
+    int      r;
+    while ((r = object_next(c, &k)) > 0) {
+        bool ok;
+        if      (KEY_IS(k, "id"))        ok = read_int(c, &w->id);
+        else if (KEY_IS(k, "monitorID")) ok = read_int(c, &w->monitor_id);
+        else if (KEY_IS(k, "name"))      ok = read_string(c, w->name, sizeof w->name);
+        else                             ok = skip_value(c);
+        if (!ok) return false;
+    }
+    return r == 0;
+}
+
+static bool parse_client(JsonCursor *c, HyprClient *cl)
+{
+    if (!expect(c, '{')) return false;
+
+    cl->address   = 0;
+    cl->workspace = -1;
+
+    JsonSpan k;
+    int      r;
+    while ((r = object_next(c, &k)) > 0) {
+        bool ok;
+        if (KEY_IS(k, "address")) {
+            char addr[32];
+            ok = read_string(c, addr, sizeof addr);
+            if (ok) cl->address = strtoull(addr, NULL, 16);
+        } else if (KEY_IS(k, "workspace")) {
+            ok = parse_ws_ref(c, &cl->workspace);
+        } else {
+            ok = skip_value(c);
+        }
+        if (!ok) return false;
+    }
+    return r == 0;
+}
+
+int json_count(const JsonCursor *c)
+{
+    JsonCursor it = *c;
+    if (!expect(&it, '[')) return -1;
+
+    int n = 0, r;
+    while ((r = array_next(&it)) > 0) {
+        if (!skip_value(&it)) return -1;
+        n++;
+    }
+    return r == 0 ? n : -1;
+}
+
+int json_parse_monitors(JsonCursor *c, HyprMonitor *out, int max)
+{
+    if (!expect(c, '[')) return -1;
+
+    int n = 0, r;
+    while ((r = array_next(c)) > 0) {
+        bool ok = (n < max) ? parse_monitor(c, &out[n]) : skip_value(c);
+        if (!ok) return -1;
+        if (n < max) n++;
+    }
+    return r == 0 ? n : -1;
+}
+
+int json_parse_workspaces(JsonCursor *c, HyprWorkspace *out, int max)
+{
+    if (!expect(c, '[')) return -1;
+
+    int n = 0, r;
+    while ((r = array_next(c)) > 0) {
+        bool ok = (n < max) ? json_parse_workspace(c, &out[n]) : skip_value(c);
+        if (!ok) return -1;
+        if (n < max) n++;
+    }
+    return r == 0 ? n : -1;
+}
+
+int json_parse_clients(JsonCursor *c, HyprClient *out, int max)
+{
+    if (!expect(c, '[')) return -1;
+
+    int n = 0, r;
+    while ((r = array_next(c)) > 0) {
+        bool ok = (n < max) ? parse_client(c, &out[n]) : skip_value(c);
+        if (!ok) return -1;
+        if (n < max) n++;
+    }
+    return r == 0 ? n : -1;
+}
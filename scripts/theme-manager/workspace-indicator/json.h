@@ -0,0 +1,62 @@
+/*
+ * json.h — single-pass reader for Hyprland `-j` replies
+ *
+ * Walks the reply exactly once and copies only the fields the indicator
+ * uses into caller-owned fixed structs.  No allocation, no intermediate
+ * copies; nesting and string escapes are handled properly so a window
+ * title containing `"id":` or `}` cannot derail the parse.
+ *
+ * Every json_parse_* call consumes one top-level value and leaves the
+ * cursor just past it, so concatenated replies can be read back to back.
+ */
+
+#ifndef WI_JSON_H
+#define WI_JSON_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct {
+    const char *p;
+    const char *end;
+} JsonCursor;
+
+typedef struct {
+    char name[128];
+    int  id;                          /* Hyprland monitor id */
+    int  x, y, width, height;
+    char make[128];
+    char model[128];
+    int  active_ws;                   /* workspace shown on this output */
+    bool focused;
+} HyprMonitor;
+
+typedef struct {
+    int  id;
+    int  monitor_id;                  /* -1 when unassigned */
+    char name[128];
+} HyprWorkspace;
+
+typedef struct {
+    unsigned long long address;       /* the 0x… handle socket2 events use */
+    int                workspace;     /* workspace id */
+} HyprClient;
+
+void json_cursor_init(JsonCursor *c, const char *js, size_t len);
+
+/* Elements in the array at the cursor, or -1; the cursor does not move. */
+int  json_count(const JsonCursor *c);
+
+/* `monitors -j`: fills up to max entries, returns the number parsed or -1. */
+int  json_parse_monitors(JsonCursor *c, HyprMonitor *out, int max);
+
+/* `workspaces -j`: fills up to max entries, returns the number parsed or -1. */
+int  json_parse_workspaces(JsonCursor *c, HyprWorkspace *out, int max);
+
+/* `activeworkspace -j`: a single workspace object. */
+bool json_parse_workspace(JsonCursor *c, HyprWorkspace *out);
+
+/* `clients -j`: fills up to max entries, returns the number parsed or -1. */
+int  json_parse_clients(JsonCursor *c, HyprClient *out, int max);
+
+#endif /* WI_JSON_H */
@@ -1,700 +1,3025 @@
 /*
  * workspace-indicator — Minimal workspace OSD for Hyprland
  *
- * Displays a macOS-style frosted pill with dot indicators at bottom-centre.
- * Auto-triggers on workspace switch (Hyprland IPC); manual peek via SIGUSR1.
- * Reads theme colours from the active hyprland-palette.conf at startup.
+ * Displays a macOS-style frosted pill with dot indicators at bottom-centre
+ * of the focused output (or of every output with --all-outputs).
+ * Auto-triggers on workspace switch (Hyprland socket2 events) and queries
+ * state over the Hyprland request socket.  Controlled through a Unix
+ * socket in $XDG_RUNTIME_DIR (`workspace-indicator ctl peek|show <ws>|
+ * reload-palette|stats|state`); SIGUSR1 (peek) and SIGUSR2 (palette)
+ * still work.  Latency/counter stats go to stderr on SIGHUP and at exit.
+ * `--render-bench` times model update and drawing headless, in the same
+ * TSV as bench/hotpath-bench; `--render-png <dir>` writes golden images.
+ * `--startup-trace` prints how long each startup phase took; the IPC
+ * snapshot and palette load overlap GTK initialisation on a worker.
+ * Supports systemd socket activation on the control socket; with
+ * `--idle-exit <s>` it quits after being hidden that long and leaves a
+ * warm-state file for the next start.
+ * Reads theme colours from the active hyprland-palette.conf and follows
+ * theme switches via inotify.
  *
  * Build:   make
  * Install: make install
  * Deps:    gtk+-3.0  gtk-layer-shell-0
+ *          wayland-client + wayland-protocols ≥ 1.36 (optional, for
+ *          compositor-side fades via wp_alpha_modifier_v1)
  */
 
 #define _GNU_SOURCE
 #include <cairo.h>
-#include <ctype.h>
+#include <errno.h>
 #include <fcntl.h>
 #include <gtk-layer-shell.h>
 #include <glib-unix.h>
 #include <gtk/gtk.h>
 #include <math.h>
-#include <pthread.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/file.h>
+#include <sys/inotify.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
 #include <sys/un.h>
 #include <unistd.h>
 
+#include "benchrun.h"
+#include "indicator.h"
+#include "json.h"
+#include "palette.h"
+#include "socket2.h"
+#include "strip.h"
+#include "wsset.h"
+
+#ifdef HAVE_ALPHA_MODIFIER
+#include <gdk/gdkwayland.h>
+#include "alpha-modifier-v1-client-protocol.h"
+#endif
+
 /* ── Tunables ────────────────────────────────────────────────────── */
+/* Limits the benches share (dots, outputs, buffers) are in indicator.h. */
 enum {
-    DISPLAY_MS    = 1200,   /* visible hold duration                 */
-    FADE_IN_MS    = 150,    /* fade-in animation                     */
-    FADE_OUT_MS   = 300,    /* fade-out animation                    */
-    DEBOUNCE_MS   = 80,     /* coalesce rapid workspace switches     */
-    MARGIN_BOTTOM = 60,     /* px from bottom edge                   */
-    DOT_SPACING   = 20,     /* centre-to-centre between dots         */
-    PAD_H         = 24,     /* horizontal pill padding               */
-    PAD_V         = 14,     /* vertical pill padding                 */
-    PERSISTENT_WS = 5,      /* always-visible workspace slots        */
-    MAX_WS        = 10,     /* hard cap on shown dots                */
-    BUF_SZ        = 4096,
+    DISPLAY_MS     = 1200,    /* visible hold duration                 */
+    FADE_IN_MS     = 150,     /* fade-in animation                     */
+    FADE_OUT_MS    = 300,     /* fade-out animation                    */
+    RECONCILE_MS   = 250,     /* quiet time before re-checking model   */
+    MARGIN_BOTTOM  = 60,      /* px from bottom edge                   */
+    DOT_SPACING    = 20,      /* centre-to-centre between dots         */
+    PAD_H          = 24,      /* horizontal pill padding               */
+    PAD_V          = 14,      /* vertical pill padding                 */
+    IPC_TIMEOUT_MS = 500,     /* request-socket send/recv timeout      */
+    RECONNECT_MIN_MS = 250,   /* socket2 reconnect back-off, doubling… */
+    RECONNECT_MAX_MS = 30000, /* …up to this; inotify usually wins     */
+    SPAWN_WAIT_MS  = 3000,    /* `ctl` wait for a daemon it started    */
 };
+G_STATIC_ASSERT((int)MAX_DOTS <= (int)STRIP_CAP);
 
-static const double DOT_R    = 4.0;   /* inactive-dot radius  */
-static const double ACTIVE_R = 5.5;   /* active-dot radius    */
+static const double DOT_R      = 4.0;   /* inactive-dot radius    */
+static const double ACTIVE_R   = 5.5;   /* active-dot radius      */
+static const double WIN_GROWTH = 0.1;   /* radius gain per window */
 
 /* ── RGBA colour ─────────────────────────────────────────────────── */
-typedef struct { double r, g, b, a; } RGBA;
 
 /* Fallback colours (Catppuccin Mocha) — overridden by palette load  */
-static RGBA col_bg      = { 0.118, 0.118, 0.180, 0.75 };
-static RGBA col_active  = { 0.537, 0.705, 0.980, 1.00 };
-static RGBA col_fg      = { 0.804, 0.839, 0.957, 0.55 };
-static RGBA col_dim     = { 0.576, 0.600, 0.698, 0.25 };
+static Palette pal = {
+    .bg     = { 0.118, 0.118, 0.180, 0.75 },
+    .active = { 0.537, 0.705, 0.980, 1.00 },
+    .fg     = { 0.804, 0.839, 0.957, 0.55 },
+    .dim    = { 0.576, 0.600, 0.698, 0.25 },
+};
+static guint palette_gen = 1;         /* bumped whenever a colour changes */
 
 /* ── Runtime state ───────────────────────────────────────────────── */
 static int        cur_ws    = 1;
-static gboolean   occ[MAX_WS + 1];   /* 1-indexed occupancy flags */
-static int        occ_max   = 0;
+static WsSet      wss;                /* occupied ids + ws → monitor map */
+static GHashTable *mon_views;         /* Hyprland monitor id → WsSet* of its workspaces */
+static int        peek_ws   = 0;    /* `show <ws>` override until the next switch */
 
-static GtkWidget *win;
-static GtkWidget *da;                 /* drawing area */
-static double     opacity   = 0.0;
-static guint      tid_hide  = 0;      /* hide-delay timer */
-static guint      tid_fade  = 0;      /* fade-step  timer */
-static guint      tid_dbnc  = 0;      /* debounce   timer */
-static char       bound_monitor[128] = "";
+/*
+ * The pill only changes with state or palette, never during a fade, so it
+ * is rasterised once and every fade frame is a single paint_with_alpha.
+ */
+typedef struct {
+    cairo_surface_t *surf;
+    int              w, h, scale;
+    DotStrip         strip;
+    guint            palette_gen;
+} PillCache;
 
+/* One pre-realized layer surface per output, created on monitor-add. */
 typedef struct {
-    char name[128];
-    int  x, y, width, height;
-    char make[128];
-    char model[128];
-} MonitorTarget;
+    GdkMonitor *monitor;
+    GtkWidget  *win;
+    GtkWidget  *da;                   /* drawing area */
+    guint       tick_id;              /* frame-clock fade callback, 0 = idle */
+    int         mon_id;               /* Hyprland monitor id, -1 = unmatched */
+    DotStrip    strip;                /* laid out by resize_da() */
+    PillCache   pill;
+#ifdef HAVE_ALPHA_MODIFIER
+    struct wp_alpha_modifier_surface_v1 *alpha;
+    struct wl_surface                   *alpha_wl;  /* surface alpha was made for */
+#endif
+} Surface;
+
+static GHashTable *surfaces;          /* GdkMonitor* → Surface* */
+static Surface    *cur_surf  = NULL;  /* output the pill is shown on */
+static gboolean    all_outputs = FALSE; /* --all-outputs: mirror on every output */
+static gboolean    client_fade = FALSE; /* --client-fade: ignore wp_alpha_modifier_v1 */
+static guint       idle_exit_s = 0;     /* --idle-exit: quit after this long hidden, 0 = never */
 
-static void build_window(void);
+static double     opacity   = 0.0;
+static guint      tid_hide  = 0;      /* hide-delay timer */
+static guint      idle_show = 0;      /* pending next-frame show */
+static guint      tid_rcnc  = 0;      /* trailing reconcile timer */
+static guint      tid_idle  = 0;      /* --idle-exit timer */
 
-/* ── Theme palette loader ────────────────────────────────────────── */
+static HyprMonitor mons[MAX_MONS];
+static int        n_mons      = 0;
+static int        focused_mon = -1;   /* index into mons[] */
+static guint      mons_gen    = 1;    /* bumped whenever mons[] changes shape */
 
-static RGBA hex8_to_rgba(const char *hex)
-{
-    unsigned r = 0, g = 0, b = 0, a = 0xFF;
-    sscanf(hex, "%2x%2x%2x%2x", &r, &g, &b, &a);
-    return (RGBA){ r / 255.0, g / 255.0, b / 255.0, a / 255.0 };
-}
+static void build_surfaces(void);
+static void sched_show(void);
+static void sched_reconcile(void);
+static void pill_refresh(void);
+
+/* ── Latency stats ───────────────────────────────────────────────── */
 
 /*
- * Read ~/.config/current/theme/hyprland-palette.conf
- * Lines: $name = rgba(RRGGBBAA)
- * Map standard names to our indicator colours.
+ * Per-stage latency histograms in the HDR style: HIST_SUB linear
+ * sub-buckets per power of two, so every sample is reported to within
+ * 12.5 % and 1 µs … ~70 min fits in a fixed array.  Recording is a
+ * bit-scan and an increment, cheap enough to leave on permanently.
+ * Dumped on SIGHUP and at exit.
  */
-static void load_palette(void)
-{
-    const char *xdg = g_get_user_config_dir();
-    char path[512];
-    g_snprintf(path, sizeof path,
-               "%s/current/theme/hyprland-palette.conf", xdg);
+enum { HIST_SUB = 8, HIST_OCTAVES = 30, HIST_BUCKETS = HIST_SUB * HIST_OCTAVES };
+
+typedef enum {
+    LAT_READ,                         /* socket2 wakeup → events applied     */
+    LAT_SHOW,                         /* first event of a burst → show ran   */
+    LAT_DRAW,                         /* first event → first frame painted   */
+    LAT_FADE,                         /* first event → fade-in complete      */
+    LAT_RESYNC,                       /* full model resync                   */
+    LAT_IPC,                          /* request-socket round trip           */
+    N_LAT
+} LatStage;
 
-    FILE *f = fopen(path, "r");
-    if (!f) {
-        g_message("workspace-indicator: no palette at %s, using fallback", path);
-        return;
-    }
+typedef struct {
+    guint64 n;
+    gint64  max_us;
+    guint32 bucket[HIST_BUCKETS];
+} Hist;
 
-    char line[256];
-    while (fgets(line, sizeof line, f)) {
-        char name[64], hex[9];
-        if (sscanf(line, " $%63[a-zA-Z_] = rgba(%8[0-9a-fA-F])", name, hex) != 2)
-            continue;
+static const char *const lat_names[N_LAT] = {
+    "read", "show", "draw", "fade", "resync", "ipc",
+};
 
-        RGBA c = hex8_to_rgba(hex);
+static struct {
+    Hist     hist[N_LAT];
+    gint64   rx_us;                   /* current socket2 wakeup, 0 outside one */
+    gint64   t0_us;                   /* first event of the burst being shown */
+    gboolean draw_pending, fade_pending;
+    guint64  shows, redraws, ipc_queries, ipc_failures, reconciles;
+} stats;
 
-        /* Map palette names → indicator roles, preserving per-role alpha */
-        if      (g_str_equal(name, "background"))  col_bg     = (RGBA){ c.r, c.g, c.b, 0.75 };
-        else if (g_str_equal(name, "accent"))       col_active = c;
-        else if (g_str_equal(name, "blue"))         col_active = c; /* blue fallback */
-        else if (g_str_equal(name, "foreground"))   col_fg     = (RGBA){ c.r, c.g, c.b, 0.55 };
-        else if (g_str_equal(name, "comment"))      col_dim    = (RGBA){ c.r, c.g, c.b, 0.25 };
-    }
-    fclose(f);
-}
+static int hist_index(gint64 us)
+{
+    if (us < HIST_SUB) return us < 0 ? 0 : (int)us;
 
-/* ── Minimal hyprctl helpers ─────────────────────────────────────── */
+    int e   = (int)g_bit_storage((gulong)us) - 1;    /* floor(log2 us) ≥ 3 */
+    int idx = (e - 2) * HIST_SUB + (int)((us >> (e - 3)) & (HIST_SUB - 1));
+    return MIN(idx, HIST_BUCKETS - 1);
+}
 
-static char *run_cmd(const char *cmd)
+/* Largest value that lands in bucket idx. */
+static gint64 hist_upper(int idx)
 {
-    FILE *fp = popen(cmd, "r");
-    if (!fp) return NULL;
+    if (idx < HIST_SUB) return idx;
 
-    size_t len = 0, cap = 0;
-    char  *buf = NULL, tmp[512];
-    while (fgets(tmp, sizeof tmp, fp)) {
-        size_t n = strlen(tmp);
-        if (len + n + 1 > cap) {
-            cap = (cap + n) * 2 + 256;
-            buf = g_realloc(buf, cap);
-        }
-        memcpy(buf + len, tmp, n);
-        len += n;
-    }
-    pclose(fp);
-    if (buf) buf[len] = '\0';
-    return buf;
+    int e = idx / HIST_SUB + 2;
+    return ((gint64)(HIST_SUB + idx % HIST_SUB + 1) << (e - 3)) - 1;
 }
 
-/* Extract first "id": <int> from JSON text */
-static int json_first_id(const char *js)
+static void stat_record(LatStage stage, gint64 us)
 {
-    const char *p = strstr(js, "\"id\":");
-    if (!p) return -1;
-    p += 5;
-    while (*p == ' ') p++;
-    return atoi(p);
+    Hist *h = &stats.hist[stage];
+    h->n++;
+    h->bucket[hist_index(us)]++;
+    if (us > h->max_us) h->max_us = us;
 }
 
-/* Collect all positive "id": <int> ≤ MAX_WS */
-static int json_all_ids(const char *js, int *ids, int max)
+static gint64 hist_percentile(const Hist *h, double p)
 {
-    int n = 0;
-    const char *p = js;
-    while (n < max && (p = strstr(p, "\"id\":")) != NULL) {
-        p += 5;
-        while (*p == ' ') p++;
-        int id = atoi(p);
-        if (id > 0 && id <= MAX_WS)
-            ids[n++] = id;
-        p++;
+    guint64 want = (guint64)ceil(p * (double)h->n), seen = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        seen += h->bucket[i];
+        if (seen >= want && seen > 0)
+            return MIN(hist_upper(i), h->max_us);
     }
-    return n;
+    return h->max_us;
 }
 
-static gboolean json_key_int(const char *js, const char *key, int *out)
+/* ── Theme palette loader ────────────────────────────────────────── */
+
+static char *palette_path(void)
 {
-    const char *p = strstr(js, key);
-    if (!p) return FALSE;
+    return g_build_filename(g_get_user_config_dir(), "current", "theme",
+                            "hyprland-palette.conf", NULL);
+}
 
-    p += strlen(key);
-    while (isspace((unsigned char)*p)) p++;
-    *out = atoi(p);
+/* Parse path over *out; FALSE if there is no such file.  No global state. */
+static gboolean palette_read(const char *path, Palette *out)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) return FALSE;
+    palette_parse(f, out);
+    fclose(f);
     return TRUE;
 }
 
-static gboolean json_key_bool(const char *js, const char *key, gboolean *out)
+static gboolean palette_apply(const Palette *next)
 {
-    const char *p = strstr(js, key);
-    if (!p) return FALSE;
+    if (memcmp(next, &pal, sizeof pal) == 0)
+        return FALSE;
 
-    p += strlen(key);
-    while (isspace((unsigned char)*p)) p++;
-
-    if (g_str_has_prefix(p, "true"))  { *out = TRUE;  return TRUE; }
-    if (g_str_has_prefix(p, "false")) { *out = FALSE; return TRUE; }
-    return FALSE;
+    pal = *next;
+    palette_gen++;
+    return TRUE;
 }
 
-static gboolean json_key_string(const char *js, const char *key,
-                                char *out, size_t out_sz)
+/*
+ * Read ~/.config/current/theme/hyprland-palette.conf (see palette.h).
+ * Returns TRUE only if a colour actually changed; only then is the pill
+ * cache invalidated.
+ */
+static gboolean load_palette(void)
 {
-    const char *p = strstr(js, key);
-    if (!p) return FALSE;
+    char    *path  = palette_path();
+    Palette  next  = pal;
+    gboolean found = palette_read(path, &next);
 
-    p += strlen(key);
-    while (isspace((unsigned char)*p)) p++;
-    if (*p != '"') return FALSE;
-    p++;
+    if (!found)
+        g_message("workspace-indicator: no palette at %s, using fallback", path);
+    g_free(path);
+    return found && palette_apply(&next);
+}
 
-    const char *end = strchr(p, '"');
-    if (!end) return FALSE;
+/* ── Hyprland request socket ─────────────────────────────────────── */
 
-    g_strlcpy(out, p, MIN(out_sz, (size_t)(end - p + 1)));
-    return TRUE;
-}
+static char *hypr_sig = NULL;         /* instance in use; follows restarts */
+static char *req_path = NULL;         /* resolved .socket.sock */
 
-static gboolean focused_monitor_target(const char *js, MonitorTarget *target)
+/*
+ * Resolve $XDG_RUNTIME_DIR/hypr/<sig>/<name>, falling back to the legacy
+ * /tmp/hypr location used by older Hyprland releases.
+ */
+static char *find_hypr_socket(const char *name)
 {
-    const char *obj = NULL;
-    int depth = 0;
+    const char *sig = hypr_sig;
+    if (!sig) return NULL;
 
-    for (const char *p = js; *p; p++) {
-        if (*p == '{') {
-            if (depth == 0)
-                obj = p;
-            depth++;
-            continue;
-        }
+    const char *xdg = g_getenv("XDG_RUNTIME_DIR");
+    char *p;
 
-        if (*p != '}')
-            continue;
+    if (xdg) {
+        p = g_strdup_printf("%s/hypr/%s/%s", xdg, sig, name);
+        if (g_file_test(p, G_FILE_TEST_EXISTS)) return p;
+        g_free(p);
+    }
+    p = g_strdup_printf("/tmp/hypr/%s/%s", sig, name);
+    if (g_file_test(p, G_FILE_TEST_EXISTS)) return p;
+    g_free(p);
+    return NULL;
+}
 
-        depth--;
-        if (depth != 0 || !obj)
-            continue;
+static int hypr_connect(const char *path)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
 
-        char *chunk = g_strndup(obj, (gsize)(p - obj + 1));
-        gboolean focused = FALSE;
-        gboolean ok = json_key_bool(chunk, "\"focused\":", &focused) && focused &&
-                      json_key_int(chunk, "\"x\":",      &target->x) &&
-                      json_key_int(chunk, "\"y\":",      &target->y) &&
-                      json_key_int(chunk, "\"width\":",  &target->width) &&
-                      json_key_int(chunk, "\"height\":", &target->height);
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    g_strlcpy(addr.sun_path, path, sizeof addr.sun_path);
 
-        if (ok) {
-            if (!json_key_string(chunk, "\"make\":", target->make, sizeof target->make))
-                target->make[0] = '\0';
-            if (!json_key_string(chunk, "\"model\":", target->model, sizeof target->model))
-                target->model[0] = '\0';
-            g_free(chunk);
-            return TRUE;
-        }
+    if (connect(fd, (struct sockaddr *)&addr, sizeof addr) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
 
-        g_free(chunk);
-        obj = NULL;
+/*
+ * Hyprland picks a new instance signature on every start, so after a
+ * compositor restart the one we were started with is stale (a crash can
+ * even leave its socket files behind).  Called when the current instance
+ * does not answer: switch to the instance whose socket2 is newest.
+ * TRUE if that is a different one.
+ */
+static gboolean hypr_instance_refresh(void)
+{
+    char  *roots[] = { g_build_filename(g_get_user_runtime_dir(), "hypr", NULL),
+                       g_strdup("/tmp/hypr") };
+    char  *best = NULL;
+    time_t best_mtime = 0;
+    for (size_t r = 0; r < G_N_ELEMENTS(roots) && !best; r++) {
+        GDir       *dir = g_dir_open(roots[r], 0, NULL);
+        const char *name;
+        while (dir && (name = g_dir_read_name(dir))) {
+            char       *sock = g_build_filename(roots[r], name, ".socket2.sock", NULL);
+            struct stat st;
+            if (stat(sock, &st) == 0 && S_ISSOCK(st.st_mode) &&
+                (!best || st.st_mtime > best_mtime)) {
+                g_free(best);
+                best       = g_strdup(name);
+                best_mtime = st.st_mtime;
+            }
+            g_free(sock);
+        }
+        if (dir) g_dir_close(dir);
+    }
+    g_free(roots[0]);
+    g_free(roots[1]);
+    if (!best || g_strcmp0(best, hypr_sig) == 0) {
+        g_free(best);
+        return FALSE;
     }
 
-    return FALSE;
+    g_message("workspace-indicator: following Hyprland instance %s", best);
+    g_free(hypr_sig);
+    hypr_sig = best;
+    g_clear_pointer(&req_path, g_free);
+    return TRUE;
 }
 
-static gboolean monitor_target_by_name(const char *js, const char *name, MonitorTarget *target)
+/*
+ * One request/reply exchange on .socket.sock — the same protocol hyprctl
+ * speaks ("j/<command>" for JSON output), minus the fork/exec.  Hyprland
+ * writes the reply and closes, so read until EOF.  Returns a g_malloc'd,
+ * NUL-terminated reply or NULL on failure.
+ */
+static char *hypr_request(const char *req)
 {
-    const char *obj = NULL;
-    int depth = 0;
-
-    for (const char *p = js; *p; p++) {
-        if (*p == '{') {
-            if (depth == 0)
-                obj = p;
-            depth++;
-            continue;
-        }
+    stats.ipc_queries++;
+    if (!req_path) req_path = find_hypr_socket(".socket.sock");
+    if (!req_path) {
+        stats.ipc_failures++;
+        return NULL;
+    }
 
-        if (*p != '}')
-            continue;
+    gint64 t0 = g_get_monotonic_time();
+    int    fd = hypr_connect(req_path);
+    if (fd < 0) {
+        /* Instance may have restarted — re-resolve on the next call. */
+        g_clear_pointer(&req_path, g_free);
+        stats.ipc_failures++;
+        return NULL;
+    }
 
-        depth--;
-        if (depth != 0 || !obj)
-            continue;
+    /* Never let a wedged compositor stall the GTK main loop. */
+    struct timeval tv = { .tv_sec  = IPC_TIMEOUT_MS / 1000,
+                          .tv_usec = (IPC_TIMEOUT_MS % 1000) * 1000 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof tv);
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof tv);
 
-        char *chunk = g_strndup(obj, (gsize)(p - obj + 1));
-        char monitor_name[sizeof target->name] = {0};
-        gboolean ok = json_key_string(chunk, "\"name\":", monitor_name, sizeof monitor_name) &&
-                      g_strcmp0(monitor_name, name) == 0 &&
-                      json_key_int(chunk, "\"x\":",      &target->x) &&
-                      json_key_int(chunk, "\"y\":",      &target->y) &&
-                      json_key_int(chunk, "\"width\":",  &target->width) &&
-                      json_key_int(chunk, "\"height\":", &target->height);
+    size_t rlen = strlen(req);
+    if (write(fd, req, rlen) != (ssize_t)rlen) {
+        close(fd);
+        stats.ipc_failures++;
+        return NULL;
+    }
 
-        if (ok) {
-            g_strlcpy(target->name, monitor_name, sizeof target->name);
-            if (!json_key_string(chunk, "\"make\":", target->make, sizeof target->make))
-                target->make[0] = '\0';
-            if (!json_key_string(chunk, "\"model\":", target->model, sizeof target->model))
-                target->model[0] = '\0';
-            g_free(chunk);
-            return TRUE;
+    size_t len = 0, cap = BUF_SZ;
+    char  *buf = g_malloc(cap);
+    ssize_t n;
+    while ((n = read(fd, buf + len, cap - len - 1)) > 0) {
+        len += (size_t)n;
+        if (cap - len < 512) {
+            cap *= 2;
+            buf = g_realloc(buf, cap);
         }
-
-        g_free(chunk);
-        obj = NULL;
     }
+    close(fd);
+    stat_record(LAT_IPC, g_get_monotonic_time() - t0);
 
-    return FALSE;
+    if (n < 0 || len == 0) {
+        g_free(buf);
+        stats.ipc_failures++;
+        return NULL;
+    }
+    buf[len] = '\0';
+    return buf;
 }
 
-static gboolean active_workspace_monitor_name(char *out, size_t out_sz)
+/*
+ * monitors + workspaces + activeworkspace in one [[BATCH]] round trip.
+ * Hyprland answers a batch within a single dispatch, so the three replies
+ * describe the same instant; it joins them with blank lines, which the
+ * JSON reader skips as whitespace between values.  The workspace array
+ * grows to whatever the reply holds and is kept for the next resync.
+ */
+typedef struct {
+    HyprMonitor    mons[MAX_MONS];
+    int            n_mons;
+    HyprWorkspace *wss;
+    int            n_wss, cap_wss;
+    HyprWorkspace  active;
+} HyprSnapshot;
+
+static void snapshot_reserve(HyprSnapshot *snap, int n)
 {
-    char *ws = run_cmd("hyprctl activeworkspace -j");
-    if (!ws) return FALSE;
-
-    gboolean ok = json_key_string(ws, "\"monitor\":", out, out_sz);
-    g_free(ws);
-    return ok;
+    if (n <= snap->cap_wss) return;
+    snap->cap_wss = MAX(n, MAX(snap->cap_wss * 2, 64));
+    snap->wss     = g_renew(HyprWorkspace, snap->wss, snap->cap_wss);
 }
 
-static GdkMonitor *match_monitor_by_identity(GdkDisplay *display,
-                                             const MonitorTarget *target)
+/* The three replies back to back; also how --render-bench seeds its model. */
+static gboolean snapshot_parse(const char *js, HyprSnapshot *snap)
 {
-    int n = gdk_display_get_n_monitors(display);
-    for (int i = 0; i < n; i++) {
-        GdkMonitor *monitor = gdk_display_get_monitor(display, i);
-        const char *make = gdk_monitor_get_manufacturer(monitor);
-        const char *model = gdk_monitor_get_model(monitor);
-
-        if (target->make[0]  && g_strcmp0(make, target->make)  != 0) continue;
-        if (target->model[0] && g_strcmp0(model, target->model) != 0) continue;
-        return monitor;
+    JsonCursor c;
+    json_cursor_init(&c, js, strlen(js));
+    snap->n_mons = json_parse_monitors(&c, snap->mons, MAX_MONS);
+
+    /* Filled to capacity: count, grow and read the array again. */
+    JsonCursor wss_at = c;
+    snap->n_wss = json_parse_workspaces(&c, snap->wss, snap->cap_wss);
+    if (snap->n_wss == snap->cap_wss) {
+        int n = json_count(&wss_at);
+        if (n > snap->cap_wss) {
+            snapshot_reserve(snap, n);
+            c           = wss_at;
+            snap->n_wss = json_parse_workspaces(&c, snap->wss, snap->cap_wss);
+        }
     }
-    return NULL;
+    return snap->n_mons >= 0 && snap->n_wss >= 0 &&
+           json_parse_workspace(&c, &snap->active);
 }
 
-static void bind_to_focused_monitor(void)
+static gboolean hypr_snapshot(HyprSnapshot *snap)
 {
-    GdkDisplay *display = gdk_display_get_default();
-    if (!display) return;
+    char *js = hypr_request("[[BATCH]]j/monitors;j/workspaces;j/activeworkspace");
+    if (!js) return FALSE;
 
-    char *monitors = run_cmd("hyprctl monitors -j");
-    if (!monitors) return;
+    gboolean ok = snapshot_parse(js, snap);
+    g_free(js);
+    if (!ok)
+        g_warning("workspace-indicator: malformed batch reply");
+    return ok;
+}
 
-    MonitorTarget target = {0};
-    char target_name[sizeof target.name] = {0};
-    gboolean resolved = active_workspace_monitor_name(target_name, sizeof target_name) &&
-                        monitor_target_by_name(monitors, target_name, &target);
+/* ── Workspace / monitor model ───────────────────────────────────── */
 
-    if (!resolved && focused_monitor_target(monitors, &target))
-        resolved = TRUE;
+/*
+ * In-memory mirror of the compositor state the pill needs.  It is seeded
+ * by one full resync whenever socket2 (re)connects and from then on kept
+ * current by socket2 events alone, so showing the OSD costs no IPC.
+ */
 
-    if (!resolved) {
-        g_warning("workspace-indicator: could not resolve target monitor");
-        g_free(monitors);
-        return;
-    }
-    g_free(monitors);
+static int mon_index_by_name(const char *name, size_t len)
+{
+    for (int i = 0; i < n_mons; i++)
+        if (strlen(mons[i].name) == len && memcmp(mons[i].name, name, len) == 0)
+            return i;
+    return -1;
+}
 
-    GdkMonitor *monitor = match_monitor_by_identity(display, &target);
-    if (!monitor) {
-        /* Fallback to monitor lookup by the Hyprland layout origin. */
-        monitor = gdk_display_get_monitor_at_point(display, target.x + 1, target.y + 1);
-    }
-    if (!monitor) {
-        g_warning("workspace-indicator: no GDK monitor matched focused output");
-        return;
+static int mon_index_by_id(int id)
+{
+    for (int i = 0; i < n_mons; i++)
+        if (mons[i].id == id)
+            return i;
+    return -1;
+}
+
+/*
+ * Per-output workspace sets, kept alongside wss so every event touches
+ * only the one or two outputs involved.
+ */
+static WsSet *mon_view(int mon_id, gboolean create)
+{
+    if (mon_id < 0) return NULL;
+    if (!mon_views)
+        mon_views = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+
+    WsSet *v = g_hash_table_lookup(mon_views, GINT_TO_POINTER(mon_id));
+    if (!v && create) {
+        v = g_new0(WsSet, 1);
+        g_hash_table_insert(mon_views, GINT_TO_POINTER(mon_id), v);
     }
+    return v;
+}
 
-    gtk_layer_set_monitor(GTK_WINDOW(win), monitor);
-    if (target.name[0])
-        g_strlcpy(bound_monitor, target.name, sizeof bound_monitor);
+static void ws_add(int id)
+{
+    wsset_add(&wss, id);
+    WsSet *v = mon_view(wsset_monitor(&wss, id), TRUE);
+    if (v && wsset_has(&wss, id)) wsset_add(v, id);
+}
 
-    if (!gtk_widget_get_visible(win))
-        gtk_widget_show_all(win);
+static void ws_remove(int id)
+{
+    WsSet *v = mon_view(wsset_monitor(&wss, id), FALSE);
+    if (v) wsset_remove(v, id);
+    wsset_remove(&wss, id);
+    wsset_set_monitor(&wss, id, -1);
 }
 
-static void refresh_state(void)
+/* Record that workspace id lives on monitor mon_id (-1: unknown). */
+static void ws_move(int id, int mon_id)
 {
-    memset(occ, 0, sizeof occ);
-    occ_max = 0;
+    int old = wsset_monitor(&wss, id);
+    if (old == mon_id) return;
+
+    WsSet *v = mon_view(old, FALSE);
+    if (v) wsset_remove(v, id);
+    wsset_set_monitor(&wss, id, mon_id);
+    if ((v = mon_view(mon_id, TRUE)) && wsset_has(&wss, id))
+        wsset_add(v, id);
+}
 
-    char *ws = run_cmd("hyprctl activeworkspace -j");
-    if (ws) {
-        cur_ws = json_first_id(ws);
-        if (cur_ws < 1) cur_ws = 1;
-        g_free(ws);
+/* After a resync: rebuild every output's view from the ws → monitor map. */
+static void views_rebuild(void)
+{
+    GHashTable *fresh = g_hash_table_new(g_direct_hash, g_direct_equal);
+    for (int ws = wsset_next(&wss, 0); ws; ws = wsset_next(&wss, ws)) {
+        int mon = wsset_monitor(&wss, ws);
+        if (mon < 0) continue;
+        WsSet *v = g_hash_table_lookup(fresh, GINT_TO_POINTER(mon));
+        if (!v) {
+            v = g_new0(WsSet, 1);
+            g_hash_table_insert(fresh, GINT_TO_POINTER(mon), v);
+        }
+        wsset_add(v, ws);
     }
-
-    char *all = run_cmd("hyprctl workspaces -j");
-    if (all) {
-        int ids[MAX_WS];
-        int n = json_all_ids(all, ids, MAX_WS);
-        for (int i = 0; i < n; i++) {
-            occ[ids[i]] = TRUE;
-            if (ids[i] > occ_max) occ_max = ids[i];
+    for (int i = 0; i < n_mons; i++)
+        mon_view(mons[i].id, TRUE);
+
+    GHashTableIter it;
+    gpointer       key, value;
+    g_hash_table_iter_init(&it, mon_views);
+    while (g_hash_table_iter_next(&it, &key, &value)) {
+        if (mon_index_by_id(GPOINTER_TO_INT(key)) < 0) {
+            g_hash_table_iter_remove(&it);
+            continue;
+        }
+        WsSet *src = g_hash_table_lookup(fresh, key);
+        WsSet  empty;
+        wsset_init(&empty);
+        wsset_replace(value, src ? src : &empty);
+        if (src) {
+            g_hash_table_remove(fresh, key);
+            g_free(src);
         }
-        g_free(all);
     }
+
+    /* Views for monitors that only just appeared. */
+    g_hash_table_iter_init(&it, fresh);
+    while (g_hash_table_iter_next(&it, &key, &value))
+        g_hash_table_insert(mon_views, key, value);
+    g_hash_table_destroy(fresh);
 }
 
-/* ── Geometry ────────────────────────────────────────────────────── */
+/*
+ * Window counts per workspace, for dot sizing.  Seeded by one `clients`
+ * query per socket2 connect and from then on kept by open/close/move
+ * events, so a switch still costs no IPC.  openwindow names its
+ * workspace rather than numbering it, hence the name → id map.
+ */
+static GHashTable *win_ws;            /* window address → workspace id */
+static GHashTable *ws_wins;           /* workspace id → window count */
+static GHashTable *ws_names;          /* workspace name → id */
 
-static int dot_count(void)
+static void windows_init(void)
 {
-    int hi = occ_max > cur_ws ? occ_max : cur_ws;
-    if (hi < PERSISTENT_WS) hi = PERSISTENT_WS;
-    if (hi > MAX_WS) hi = MAX_WS;
-    return hi;
+    win_ws   = g_hash_table_new(g_direct_hash, g_direct_equal);
+    ws_wins  = g_hash_table_new(g_direct_hash, g_direct_equal);
+    ws_names = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
 }
 
-static void resize_da(void)
+static int win_count(int ws)
 {
-    int n = dot_count();
-    int w = PAD_H * 2 + (n - 1) * DOT_SPACING + (int)(ACTIVE_R * 2);
-    int h = PAD_V * 2 + (int)(ACTIVE_R * 2);
-    gtk_widget_set_size_request(da, w, h);
+    return GPOINTER_TO_INT(g_hash_table_lookup(ws_wins, GINT_TO_POINTER(ws)));
 }
 
-/* ── Cairo draw ──────────────────────────────────────────────────── */
+static void win_count_add(int ws, int delta)
+{
+    int n = win_count(ws) + delta;
+    if (n > 0) g_hash_table_insert(ws_wins, GINT_TO_POINTER(ws), GINT_TO_POINTER(n));
+    else       g_hash_table_remove(ws_wins, GINT_TO_POINTER(ws));
+}
 
-static gboolean on_draw(GtkWidget *widget, cairo_t *cr, gpointer data)
+/* Idempotent, so events racing the seed query cannot double-count. */
+static void win_place(guintptr addr, int ws)
 {
-    (void)data;
-    double a = opacity;
-    if (a < 0.001) return FALSE;
+    gpointer old;
+    if (g_hash_table_lookup_extended(win_ws, GSIZE_TO_POINTER(addr), NULL, &old)) {
+        if (GPOINTER_TO_INT(old) == ws) return;
+        win_count_add(GPOINTER_TO_INT(old), -1);
+    }
+    g_hash_table_insert(win_ws, GSIZE_TO_POINTER(addr), GINT_TO_POINTER(ws));
+    win_count_add(ws, 1);
+}
 
-    GtkAllocation alloc;
-    gtk_widget_get_allocation(widget, &alloc);
-    double w = alloc.width, h = alloc.height;
+static void win_forget(guintptr addr)
+{
+    gpointer old;
+    if (!g_hash_table_lookup_extended(win_ws, GSIZE_TO_POINTER(addr), NULL, &old))
+        return;
+    win_count_add(GPOINTER_TO_INT(old), -1);
+    g_hash_table_remove(win_ws, GSIZE_TO_POINTER(addr));
+}
 
-    /* Pill background */
-    double r = h / 2.0;
-    cairo_new_sub_path(cr);
-    cairo_arc(cr, r, r, r, G_PI * 0.5, G_PI * 1.5);
-    cairo_arc(cr, w - r, r, r, G_PI * 1.5, G_PI * 0.5);
-    cairo_close_path(cr);
-    cairo_set_source_rgba(cr, col_bg.r, col_bg.g, col_bg.b, col_bg.a * a);
-    cairo_fill(cr);
+static gboolean name_has_id(gpointer key, gpointer value, gpointer id)
+{
+    (void)key;
+    return value == id;
+}
 
-    /* Dots */
-    int n = dot_count();
-    double span = (double)(n - 1) * DOT_SPACING;
-    double sx   = (w - span) / 2.0;
-    double cy   = h / 2.0;
+static void ws_name_set(int id, const char *name)
+{
+    g_hash_table_foreach_remove(ws_names, name_has_id, GINT_TO_POINTER(id));
+    if (name && *name)
+        g_hash_table_insert(ws_names, g_strdup(name), GINT_TO_POINTER(id));
+}
 
-    for (int i = 0; i < n; i++) {
-        int    ws  = i + 1;
-        double cx  = sx + (double)i * DOT_SPACING;
-        RGBA   c;
-        double dr;
+/* Numeric names are their own id; anything else goes through the map. */
+static int ws_id_by_name(const char *name)
+{
+    char *end;
+    long  id = strtol(name, &end, 10);
+    if (end != name && *end == '\0') return (int)id;
 
-        if (ws == cur_ws)      { c = col_active; dr = ACTIVE_R; }
-        else if (occ[ws])      { c = col_fg;     dr = DOT_R;    }
-        else                   { c = col_dim;    dr = DOT_R - 1; }
+    gpointer v;
+    return g_hash_table_lookup_extended(ws_names, name, NULL, &v) ? GPOINTER_TO_INT(v) : 0;
+}
 
-        cairo_set_source_rgba(cr, c.r, c.g, c.b, c.a * a);
-        cairo_arc(cr, cx, cy, dr, 0, G_PI * 2);
-        cairo_fill(cr);
-    }
+/* `j/clients` into out; the number read, or -1.  Touches no model state. */
+static int windows_fetch(HyprClient *out, int max)
+{
+    char *js = hypr_request("j/clients");
+    if (!js) return -1;
+
+    JsonCursor c;
+    json_cursor_init(&c, js, strlen(js));
+    int n = json_parse_clients(&c, out, max);
+    g_free(js);
+    if (n < 0)
+        g_warning("workspace-indicator: malformed clients reply");
+    return n;
+}
 
-    return FALSE;
+static void windows_apply(const HyprClient *clients, int n)
+{
+    g_hash_table_remove_all(win_ws);
+    g_hash_table_remove_all(ws_wins);
+    for (int i = 0; i < n; i++)
+        win_place((guintptr)clients[i].address, clients[i].workspace);
 }
 
-/* ── Fade animation ──────────────────────────────────────────────── */
+static void windows_seed(void)
+{
+    static HyprClient clients[MAX_CLIENTS];
 
-static double fade_tgt;
-static double fade_step_d;
+    int n = windows_fetch(clients, MAX_CLIENTS);
+    if (n >= 0) windows_apply(clients, n);
+}
 
-static gboolean fade_step(gpointer data)
+static void set_focused_mon(int idx)
 {
-    (void)data;
-    opacity += fade_step_d;
-    gboolean done = (fade_step_d >= 0)
-        ? (opacity >= fade_tgt)
-        : (opacity <= fade_tgt);
-    if (done) opacity = fade_tgt;
-
-    gtk_widget_queue_draw(da);
-
-    if (done) {
-        tid_fade = 0;
-        if (fade_tgt <= 0.0)
-            gtk_widget_set_opacity(win, 0.0);
-        return G_SOURCE_REMOVE;
-    }
-    return G_SOURCE_CONTINUE;
+    focused_mon = idx;
+    if (idx >= 0 && mons[idx].active_ws > 0)
+        cur_ws = mons[idx].active_ws;
 }
 
-static void fade_to(double target, int ms)
+/* Replace the model with a snapshot taken by hypr_snapshot(). */
+static void model_apply(const HyprSnapshot *snap)
 {
-    if (tid_fade) { g_source_remove(tid_fade); tid_fade = 0; }
-    int steps = ms / 16;
-    if (steps < 1) steps = 1;
-    fade_tgt    = target;
-    fade_step_d = (target - opacity) / (double)steps;
-    tid_fade    = g_timeout_add(16, fade_step, NULL);
-}
+    memcpy(mons, snap->mons, (size_t)snap->n_mons * sizeof mons[0]);
+    n_mons      = snap->n_mons;
+    mons_gen++;
+    focused_mon = -1;
+    for (int i = 0; i < n_mons; i++)
+        if (mons[i].focused) focused_mon = i;
+    set_focused_mon(focused_mon);
+
+    WsSet fresh;
+    wsset_init(&fresh);
+    g_hash_table_remove_all(ws_names);
+    for (int i = 0; i < snap->n_wss; i++) {
+        const HyprWorkspace *w = &snap->wss[i];
+        wsset_add(&fresh, w->id);
+        wsset_set_monitor(&fresh, w->id, w->monitor_id);
+        if (w->name[0])
+            g_hash_table_insert(ws_names, g_strdup(w->name), GINT_TO_POINTER(w->id));
+    }
+    wsset_replace(&wss, &fresh);
+    views_rebuild();
 
-/* ── Show / hide ─────────────────────────────────────────────────── */
+    /* activeworkspace is authoritative for the focused output. */
+    if (snap->active.id > 0) cur_ws = snap->active.id;
+}
 
-static gboolean begin_hide(gpointer data)
+/*
+ * Full resync — on socket2 (re)connect, hotplug, and once a handler had to
+ * guess (sched_reconcile); never on show.
+ */
+static void model_resync(void)
 {
-    (void)data;
-    tid_hide = 0;
-    fade_to(0.0, FADE_OUT_MS);
-    return G_SOURCE_REMOVE;
+    static HyprSnapshot snap;
+    gint64 t0 = g_get_monotonic_time();
+    if (!hypr_snapshot(&snap)) return;
+
+    model_apply(&snap);
+    stat_record(LAT_RESYNC, g_get_monotonic_time() - t0);
 }
 
-static void show_indicator(void)
+/*
+ * socket2 event handlers.  Each receives the payload after ">>" (NUL-
+ * terminated in the reader's buffer) and is registered in ipc_events[].
+ * Switch and focus changes surface the OSD.
+ */
+
+static void ev_workspacev2(char *arg, size_t len, void *user)
 {
-    refresh_state();
-    if (cur_ws < 1) return;           /* skip special workspaces */
+    (void)len; (void)user;
 
-    if (tid_hide) { g_source_remove(tid_hide); tid_hide = 0; }
-    if (tid_fade) { g_source_remove(tid_fade); tid_fade = 0; }
+    /* ID,NAME — special workspaces (id < 1) never reach the pill */
+    int id = atoi(arg);
+    if (id < 1) return;
 
-    bind_to_focused_monitor();
-    resize_da();
-    gtk_widget_queue_draw(da);
-    gtk_widget_set_opacity(win, 1.0);
-    fade_to(1.0, FADE_IN_MS);
-    tid_hide = g_timeout_add(DISPLAY_MS, begin_hide, NULL);
+    int mon = wsset_monitor(&wss, id);
+    int idx = mon >= 0 ? mon_index_by_id(mon) : -1;
+    if (idx < 0) {
+        idx = focused_mon;            /* assume it opened where focus is */
+        sched_reconcile();
+    }
+    if (idx >= 0) {
+        mons[idx].active_ws = id;
+        ws_move(id, mons[idx].id);
+        focused_mon = idx;
+    }
+    cur_ws  = id;
+    peek_ws = 0;
+    ws_add(id);
+    sched_show();
 }
 
-/* ── Debounced trigger (thread-safe) ─────────────────────────────── */
+static void ev_focusedmon(char *arg, size_t len, void *user)
+{
+    (void)len; (void)user;
+
+    /* MONNAME,WORKSPACENAME */
+    const char *comma = strchr(arg, ',');
+    if (!comma) return;
+
+    int idx = mon_index_by_name(arg, (size_t)(comma - arg));
+    if (idx < 0) {
+        /* Output we have not seen yet (raced its monitoradded). */
+        model_resync();
+        idx = mon_index_by_name(arg, (size_t)(comma - arg));
+        if (idx < 0) sched_reconcile();
+    }
+    /* A name, not an id: "3" for numbered workspaces, "web" for named. */
+    int ws = ws_id_by_name(comma + 1);
+    if (ws == 0) sched_reconcile();   /* name not seen yet */
+    if (idx >= 0 && ws > 0) mons[idx].active_ws = ws;
+    set_focused_mon(idx);
+    peek_ws = 0;
+    sched_show();
+}
 
-static gboolean do_show(gpointer data)
+static void ev_createworkspacev2(char *arg, size_t len, void *user)
 {
-    (void)data;
-    tid_dbnc = 0;
-    show_indicator();
-    return G_SOURCE_REMOVE;
+    (void)len; (void)user;
+
+    /* ID,NAME — no monitor in the payload.  Hyprland creates workspaces
+     * on the focused output unless a rule pins them elsewhere; the
+     * trailing reconcile corrects the exceptions. */
+    int id = atoi(arg);
+    if (id < 1) return;               /* special workspaces never reach the pill */
+    if (wsset_monitor(&wss, id) < 0) {
+        if (focused_mon >= 0) ws_move(id, mons[focused_mon].id);
+        sched_reconcile();
+    }
+    ws_add(id);
+
+    const char *name = strchr(arg, ',');
+    if (name) ws_name_set(id, name + 1);
 }
 
-static gboolean sched_show(gpointer data)
+static void ev_destroyworkspacev2(char *arg, size_t len, void *user)
 {
-    (void)data;
-    if (tid_dbnc) g_source_remove(tid_dbnc);
-    tid_dbnc = g_timeout_add(DEBOUNCE_MS, do_show, NULL);
-    return G_SOURCE_REMOVE;        /* remove idle source */
+    (void)len; (void)user;
+    int id = atoi(arg);
+    ws_remove(id);
+    ws_name_set(id, NULL);
 }
 
-static void trigger(void) { g_idle_add(sched_show, NULL); }
+static void ev_renameworkspace(char *arg, size_t len, void *user)
+{
+    (void)len; (void)user;
 
-/* ── IPC listener thread ─────────────────────────────────────────── */
+    /* ID,NEWNAME */
+    const char *name = strchr(arg, ',');
+    if (name) ws_name_set(atoi(arg), name + 1);
+}
 
-static char *find_socket2(void)
+static void ev_openwindow(char *arg, size_t len, void *user)
 {
-    const char *sig = g_getenv("HYPRLAND_INSTANCE_SIGNATURE");
-    if (!sig) return NULL;
+    (void)len; (void)user;
+
+    /* ADDRESS,WORKSPACENAME,CLASS,TITLE */
+    char *name = strchr(arg, ',');
+    if (!name) return;
+    char *end = strchr(++name, ',');
+    if (end) *end = '\0';
+
+    int ws = ws_id_by_name(name);
+    if (ws == 0) return;              /* unknown name: the next seed has it */
+    win_place((guintptr)strtoull(arg, NULL, 16), ws);
+    pill_refresh();
+}
 
-    const char *xdg = g_getenv("XDG_RUNTIME_DIR");
-    char *p;
+static void ev_closewindow(char *arg, size_t len, void *user)
+{
+    (void)len; (void)user;
 
-    if (xdg) {
-        p = g_strdup_printf("%s/hypr/%s/.socket2.sock", xdg, sig);
-        if (g_file_test(p, G_FILE_TEST_EXISTS)) return p;
-        g_free(p);
-    }
-    p = g_strdup_printf("/tmp/hypr/%s/.socket2.sock", sig);
-    if (g_file_test(p, G_FILE_TEST_EXISTS)) return p;
-    g_free(p);
-    return NULL;
+    /* ADDRESS */
+    win_forget((guintptr)strtoull(arg, NULL, 16));
+    pill_refresh();
 }
 
-static void *ipc_thread(void *arg)
+static void ev_movewindowv2(char *arg, size_t len, void *user)
 {
-    (void)arg;
-    char *path = find_socket2();
-    if (!path) {
-        g_warning("workspace-indicator: cannot locate Hyprland socket2");
-        return NULL;
-    }
+    (void)len; (void)user;
 
-    for (;;) {
-        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
-        if (fd < 0) { sleep(1); continue; }
+    /* ADDRESS,WORKSPACEID,WORKSPACENAME */
+    const char *id = strchr(arg, ',');
+    if (!id) return;
+    win_place((guintptr)strtoull(arg, NULL, 16), atoi(id + 1));
+    pill_refresh();
+}
 
-        struct sockaddr_un addr = { .sun_family = AF_UNIX };
-        g_strlcpy(addr.sun_path, path, sizeof addr.sun_path);
+static void ev_moveworkspacev2(char *arg, size_t len, void *user)
+{
+    (void)len; (void)user;
 
-        if (connect(fd, (struct sockaddr *)&addr, sizeof addr) < 0) {
-            close(fd);
-            sleep(1);
+    /* ID,NAME,MONNAME — the name may itself contain commas */
+    int id = atoi(arg);
+    const char *mon = strrchr(arg, ',');
+    if (!mon || id < 1) return;
+
+    int idx = mon_index_by_name(mon + 1, strlen(mon + 1));
+    if (idx < 0) sched_reconcile();   /* output not known yet */
+    ws_move(id, idx >= 0 ? mons[idx].id : -1);
+}
+
+static void ev_monitoraddedv2(char *arg, size_t len, void *user)
+{
+    (void)arg; (void)len; (void)user;
+
+    /* Geometry and identity are not in the payload; hotplug is rare
+     * enough that one batched resync here is fine. */
+    model_resync();
+}
+
+static void ev_monitorremoved(char *arg, size_t len, void *user)
+{
+    (void)user;
+    int idx = mon_index_by_name(arg, len);
+    if (idx < 0) return;
+
+    /* Its workspaces follow as moveworkspacev2 events. */
+    if (mon_views)
+        g_hash_table_remove(mon_views, GINT_TO_POINTER(mons[idx].id));
+    memmove(&mons[idx], &mons[idx + 1],
+            (size_t)(n_mons - idx - 1) * sizeof mons[0]);
+    n_mons--;
+    mons_gen++;
+    if (focused_mon == idx)     focused_mon = -1;
+    else if (focused_mon > idx) focused_mon--;
+}
+
+/* Listed in indicator.h, which the benches share. */
+static const S2Event ipc_events[] = { WI_IPC_EVENTS(S2_EVENT) };
+
+/* ── Output map ──────────────────────────────────────────────────── */
+
+/*
+ * Hyprland monitor name → GdkMonitor, resolved once per topology change
+ * instead of on every show.  GDK hotplug signals rebuild it directly;
+ * socket2 changes to mons[] bump mons_gen and the next lookup rebuilds.
+ * Values are borrowed — the map is rebuilt on every monitor-removed.
+ */
+static GHashTable *out_map;
+static guint       out_map_gen = 0;
+
+static GdkMonitor *match_monitor_by_identity(GdkDisplay *display,
+                                             const HyprMonitor *target)
+{
+    GdkMonitor *first = NULL;
+    int n = gdk_display_get_n_monitors(display);
+    for (int i = 0; i < n; i++) {
+        GdkMonitor *monitor = gdk_display_get_monitor(display, i);
+        const char *make = gdk_monitor_get_manufacturer(monitor);
+        const char *model = gdk_monitor_get_model(monitor);
+
+        if (target->make[0]  && g_strcmp0(make, target->make)  != 0) continue;
+        if (target->model[0] && g_strcmp0(model, target->model) != 0) continue;
+
+        /* Identical panels share make/model; the layout origin tells them apart. */
+        GdkRectangle geo;
+        gdk_monitor_get_geometry(monitor, &geo);
+        if (geo.x == target->x && geo.y == target->y)
+            return monitor;
+        if (!first)
+            first = monitor;
+    }
+    return first;
+}
+
+static void out_map_rebuild(void)
+{
+    GdkDisplay *display = gdk_display_get_default();
+    if (!display) return;
+
+    if (!out_map)
+        out_map = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    g_hash_table_remove_all(out_map);
+
+    GHashTableIter it;
+    gpointer       value;
+    if (surfaces) {
+        g_hash_table_iter_init(&it, surfaces);
+        while (g_hash_table_iter_next(&it, NULL, &value))
+            ((Surface *)value)->mon_id = -1;
+    }
+
+    for (int i = 0; i < n_mons; i++) {
+        GdkMonitor *monitor = match_monitor_by_identity(display, &mons[i]);
+        if (!monitor) {
+            /* Fallback to monitor lookup by the Hyprland layout origin. */
+            monitor = gdk_display_get_monitor_at_point(display, mons[i].x + 1, mons[i].y + 1);
+        }
+        if (!monitor) continue;
+
+        g_hash_table_insert(out_map, g_strdup(mons[i].name), monitor);
+        Surface *surf = surfaces ? g_hash_table_lookup(surfaces, monitor) : NULL;
+        if (surf) surf->mon_id = mons[i].id;
+    }
+    out_map_gen = mons_gen;
+}
+
+static GdkMonitor *out_map_lookup(const HyprMonitor *target)
+{
+    if (!out_map || out_map_gen != mons_gen)
+        out_map_rebuild();
+    return out_map ? g_hash_table_lookup(out_map, target->name) : NULL;
+}
+
+/* Surface for the output Hyprland reports as focused. */
+static Surface *focused_surface(void)
+{
+    if (focused_mon < 0 || !surfaces) {
+        g_warning("workspace-indicator: could not resolve target monitor");
+        return NULL;
+    }
+
+    GdkMonitor *monitor = out_map_lookup(&mons[focused_mon]);
+    Surface    *surf    = monitor ? g_hash_table_lookup(surfaces, monitor) : NULL;
+    if (!surf)
+        g_warning("workspace-indicator: no GDK monitor matched focused output");
+    return surf;
+}
+
+/* Apply fn to the surfaces that currently carry the pill. */
+static void foreach_visible(void (*fn)(Surface *surf, gpointer data), gpointer data)
+{
+    if (!all_outputs) {
+        if (cur_surf) fn(cur_surf, data);
+        return;
+    }
+
+    GHashTableIter it;
+    gpointer       value;
+    g_hash_table_iter_init(&it, surfaces);
+    while (g_hash_table_iter_next(&it, NULL, &value))
+        fn(value, data);
+}
+
+static void surface_queue_draw(Surface *surf, gpointer data)
+{
+    (void)data;
+    gtk_widget_queue_draw(surf->da);
+}
+
+/* ── Geometry ────────────────────────────────────────────────────── */
+
+/* Workspace the pill highlights. */
+static int shown_ws(void)
+{
+    return peek_ws > 0 ? peek_ws : cur_ws;
+}
+
+/*
+ * Lay out one output's strip (see strip.h).  An output Hyprland has not
+ * been matched to falls back to every workspace.
+ */
+static int strip_win_count(int ws, void *user)
+{
+    (void)user;
+    return win_count(ws);
+}
+
+static DotStrip dot_strip(const Surface *surf)
+{
+    static const StripParams params = {
+        .persistent = PERSISTENT_WS,
+        .max_dots   = MAX_DOTS,
+        .win_steps  = WIN_STEPS,
+        .win_count  = strip_win_count,
+    };
+
+    if (!out_map || out_map_gen != mons_gen)
+        out_map_rebuild();
+
+    int          idx    = surf->mon_id >= 0 ? mon_index_by_id(surf->mon_id) : -1;
+    const WsSet *view   = idx >= 0 ? mon_view(surf->mon_id, TRUE) : &wss;
+    int          active = idx < 0 || idx == focused_mon ? shown_ws() : mons[idx].active_ws;
+
+    DotStrip d;
+    strip_layout(&d, view, &wss, active, &params);
+    return d;
+}
+
+static void pill_size(const DotStrip *d, int *w, int *h)
+{
+    int n = MAX(d->n, 1);
+    *w = PAD_H * 2 + (n - 1) * DOT_SPACING + (int)(ACTIVE_R * 2);
+    *h = PAD_V * 2 + (int)(ACTIVE_R * 2);
+}
+
+static void resize_da(void)
+{
+    GHashTableIter it;
+    gpointer       value;
+    g_hash_table_iter_init(&it, surfaces);
+    while (g_hash_table_iter_next(&it, NULL, &value)) {
+        Surface *surf = value;
+        surf->strip = dot_strip(surf);
+
+        int w, h;
+        pill_size(&surf->strip, &w, &h);
+        gtk_widget_set_size_request(surf->da, w, h);
+    }
+}
+
+/* ── Compositor-side alpha ───────────────────────────────────────── */
+
+/*
+ * With wp_alpha_modifier_v1 the pill buffer is committed once at full
+ * alpha and a fade only changes the surface's alpha multiplier: each
+ * frame is a bare wl_surface.commit with no repaint and no buffer upload.
+ * Without the protocol (or with --client-fade) every frame repaints.
+ */
+#ifdef HAVE_ALPHA_MODIFIER
+static struct wp_alpha_modifier_v1 *alpha_mgr;
+
+static void registry_global(void *data, struct wl_registry *registry,
+                            uint32_t name, const char *iface, uint32_t version)
+{
+    (void)data; (void)version;
+    if (g_str_equal(iface, wp_alpha_modifier_v1_interface.name))
+        alpha_mgr = wl_registry_bind(registry, name, &wp_alpha_modifier_v1_interface, 1);
+}
+
+static void registry_global_remove(void *data, struct wl_registry *registry, uint32_t name)
+{
+    (void)data; (void)registry; (void)name;
+}
+
+static const struct wl_registry_listener registry_listener = {
+    .global        = registry_global,
+    .global_remove = registry_global_remove,
+};
+
+/* Probe on a private queue so GDK's own event dispatch is left alone. */
+static void alpha_modifier_init(void)
+{
+    GdkDisplay *gdpy = gdk_display_get_default();
+    if (client_fade || !GDK_IS_WAYLAND_DISPLAY(gdpy)) return;
+
+    struct wl_display     *dpy     = gdk_wayland_display_get_wl_display(gdpy);
+    struct wl_event_queue *queue   = wl_display_create_queue(dpy);
+    struct wl_display     *wrapper = wl_proxy_create_wrapper(dpy);
+    wl_proxy_set_queue((struct wl_proxy *)wrapper, queue);
+
+    struct wl_registry *registry = wl_display_get_registry(wrapper);
+    wl_proxy_wrapper_destroy(wrapper);
+    wl_registry_add_listener(registry, &registry_listener, NULL);
+    wl_display_roundtrip_queue(dpy, queue);
+    wl_registry_destroy(registry);
+
+    if (alpha_mgr)
+        wl_proxy_set_queue((struct wl_proxy *)alpha_mgr, NULL);
+    wl_event_queue_destroy(queue);
+
+    g_debug("workspace-indicator: %s fades",
+            alpha_mgr ? "compositor-side (wp_alpha_modifier_v1)" : "client-side");
+}
+
+static void alpha_release(Surface *surf)
+{
+    g_clear_pointer(&surf->alpha, wp_alpha_modifier_surface_v1_destroy);
+    surf->alpha_wl = NULL;
+}
+#else
+static void alpha_modifier_init(void) {}
+static void alpha_release(Surface *surf) { (void)surf; }
+#endif
+
+/*
+ * Set surf's compositor alpha multiplier to a.  With commit the change is
+ * pushed on its own; without, it rides along with GTK's next frame.
+ * Returns FALSE when the client has to bake the alpha into its paint.
+ */
+static gboolean alpha_apply(Surface *surf, double a, gboolean commit)
+{
+#ifdef HAVE_ALPHA_MODIFIER
+    if (!alpha_mgr) return FALSE;
+
+    GdkWindow *window = gtk_widget_get_window(surf->win);
+    struct wl_surface *wl = window ? gdk_wayland_window_get_wl_surface(window) : NULL;
+    if (!wl) return FALSE;
+
+    /* GDK recreates the wl_surface across hide/show. */
+    if (surf->alpha_wl != wl) {
+        alpha_release(surf);
+        surf->alpha    = wp_alpha_modifier_v1_get_surface(alpha_mgr, wl);
+        surf->alpha_wl = wl;
+    }
+
+    wp_alpha_modifier_surface_v1_set_multiplier(surf->alpha,
+                                                (uint32_t)(CLAMP(a, 0.0, 1.0) * UINT32_MAX));
+    if (commit)
+        wl_surface_commit(wl);
+    return TRUE;
+#else
+    (void)surf; (void)a; (void)commit;
+    return FALSE;
+#endif
+}
+
+/* ── Cairo draw ──────────────────────────────────────────────────── */
+
+/* Pill + dots at full opacity; callers apply the fade alpha on top. */
+static void draw_pill(cairo_t *cr, double w, double h, const DotStrip *d)
+{
+    /* Pill background */
+    double r = h / 2.0;
+    cairo_new_sub_path(cr);
+    cairo_arc(cr, r, r, r, G_PI * 0.5, G_PI * 1.5);
+    cairo_arc(cr, w - r, r, r, G_PI * 1.5, G_PI * 0.5);
+    cairo_close_path(cr);
+    cairo_set_source_rgba(cr, pal.bg.r, pal.bg.g, pal.bg.b, pal.bg.a);
+    cairo_fill(cr);
+
+    /* Dots */
+    int      active = d->active;
+    double   span   = (double)(d->n - 1) * DOT_SPACING;
+    double   sx     = (w - span) / 2.0;
+    double   cy     = h / 2.0;
+
+    for (int i = 0; i < d->n; i++) {
+        int    ws  = d->ids[i];
+        double cx  = sx + (double)i * DOT_SPACING;
+        RGBA   c;
+        double dr;
+
+        if (ws == active)        { c = pal.active; dr = ACTIVE_R;  }
+        else if (d->occupied[i]) { c = pal.fg;     dr = DOT_R;     }
+        else                     { c = pal.dim;    dr = DOT_R - 1; }
+
+        /* Each window grows the dot a step, up to WIN_STEPS. */
+        dr *= 1.0 + WIN_GROWTH * d->wins[i];
+
+        /* Shrunken edge dots hint that the strip scrolls. */
+        if (ws != active && ((i == 0 && d->more_left) || (i == d->n - 1 && d->more_right)))
+            dr *= 0.6;
+
+        cairo_set_source_rgba(cr, c.r, c.g, c.b, c.a);
+        cairo_arc(cr, cx, cy, dr, 0, G_PI * 2);
+        cairo_fill(cr);
+    }
+}
+
+/*
+ * Per-output raster, keyed by the strip itself: a switch on one output
+ * leaves every other output's strip, and so its raster, untouched.
+ */
+static guint     pill_hits = 0, pill_misses = 0;
+
+static cairo_surface_t *pill_surface(Surface *surf, int w, int h)
+{
+    GdkWindow *window = gtk_widget_get_window(surf->da);
+    if (!window) return NULL;
+
+    PillCache *pc    = &surf->pill;
+    int        scale = gtk_widget_get_scale_factor(surf->da);
+    if (pc->surf && pc->w == w && pc->h == h && pc->scale == scale &&
+        memcmp(&pc->strip, &surf->strip, sizeof pc->strip) == 0 &&
+        pc->palette_gen == palette_gen) {
+        pill_hits++;
+        return pc->surf;
+    }
+
+    pill_misses++;
+    g_debug("workspace-indicator: pill cache miss (hits %u, misses %u)",
+            pill_hits, pill_misses);
+
+    g_clear_pointer(&pc->surf, cairo_surface_destroy);
+    pc->surf = gdk_window_create_similar_image_surface(window, CAIRO_FORMAT_ARGB32,
+                                                       w, h, scale);
+    cairo_t *cr = cairo_create(pc->surf);
+    draw_pill(cr, w, h, &surf->strip);
+    cairo_destroy(cr);
+
+    pc->w           = w;
+    pc->h           = h;
+    pc->scale       = scale;
+    pc->strip       = surf->strip;
+    pc->palette_gen = palette_gen;
+    return pc->surf;
+}
+
+static gboolean on_draw(GtkWidget *widget, cairo_t *cr, gpointer data)
+{
+    Surface *surf = data;
+    double   a    = opacity;
+
+    stats.redraws++;
+    if (stats.draw_pending) {
+        stats.draw_pending = FALSE;
+        stat_record(LAT_DRAW, g_get_monotonic_time() - stats.t0_us);
+    }
+
+    /* Compositor fade: paint the pill opaque, the multiplier does the rest. */
+    if (alpha_apply(surf, opacity, FALSE))
+        a = 1.0;
+    else if (a < 0.001)
+        return FALSE;
+
+    GtkAllocation alloc;
+    gtk_widget_get_allocation(widget, &alloc);
+
+    cairo_surface_t *pill = pill_surface(surf, alloc.width, alloc.height);
+    if (pill) {
+        cairo_set_source_surface(cr, pill, 0, 0);
+        cairo_paint_with_alpha(cr, a);
+    } else {
+        cairo_push_group(cr);
+        draw_pill(cr, alloc.width, alloc.height, &surf->strip);
+        cairo_pop_group_to_source(cr);
+        cairo_paint_with_alpha(cr, a);
+    }
+
+    return FALSE;
+}
+
+/* ── Map / unmap ─────────────────────────────────────────────────── */
+
+/*
+ * Hidden surfaces are unmapped, not left as transparent overlays: with
+ * blur on the layer, a mapped-but-empty surface still costs the compositor
+ * every frame.  Surfaces stay realized so a remap only has to wait for the
+ * layer-surface configure, and the pill raster is warmed beforehand so the
+ * first frame after it is a cached blit.
+ */
+static void surface_map(Surface *surf, gpointer data)
+{
+    (void)data;
+    if (gtk_widget_get_visible(surf->win)) return;
+
+    int w, h;
+    gtk_widget_get_size_request(surf->da, &w, &h);
+    pill_surface(surf, w, h);
+    gtk_widget_show(surf->win);
+}
+
+static void surface_unmap(Surface *surf)
+{
+    if (!gtk_widget_get_visible(surf->win)) return;
+
+    /* The modifier must go before GDK destroys its wl_surface. */
+    alpha_release(surf);
+    gtk_widget_hide(surf->win);
+}
+
+/* ── Idle exit ───────────────────────────────────────────────────── */
+
+/*
+ * With --idle-exit the daemon quits once the pill has been hidden that
+ * long.  Socket-activated, systemd keeps the control socket listening and
+ * the next `ctl` command starts it again, so the OSD only holds memory
+ * while it is in use.
+ */
+static gboolean on_idle_exit(gpointer data)
+{
+    (void)data;
+    tid_idle = 0;
+    g_message("workspace-indicator: idle for %us, exiting", idle_exit_s);
+    gtk_main_quit();
+    return G_SOURCE_REMOVE;
+}
+
+static void idle_arm(void)
+{
+    if (!idle_exit_s) return;
+    if (tid_idle) g_source_remove(tid_idle);
+    tid_idle = g_timeout_add_seconds(idle_exit_s, on_idle_exit, NULL);
+}
+
+static void idle_disarm(void)
+{
+    if (tid_idle) { g_source_remove(tid_idle); tid_idle = 0; }
+}
+
+/* ── Fade animation ──────────────────────────────────────────────── */
+
+/*
+ * Fades run on each surface's GdkFrameClock rather than a 16 ms timer, so
+ * steps land on that output's vblank at whatever rate it refreshes, and
+ * opacity is a function of elapsed time: the fade ends exactly at its
+ * deadline no matter how many frames the compositor skipped on the way.
+ */
+static struct {
+    double from, to;
+    gint64 start_us;                  /* monotonic, same base as frame time */
+    gint64 dur_us;
+} fade;
+
+static double ease(double t, gboolean in)
+{
+    double u = 1.0 - t;
+    return in ? 1.0 - u * u * u       /* ease-out cubic: snappy appear  */
+              : t * t * t;            /* ease-in cubic: lingering leave */
+}
+
+static gboolean fade_tick(GtkWidget *widget, GdkFrameClock *clock, gpointer data)
+{
+    Surface *surf = data;
+    gint64   now  = gdk_frame_clock_get_frame_time(clock);
+    double   t    = fade.dur_us > 0
+                  ? (double)(now - fade.start_us) / (double)fade.dur_us : 1.0;
+    t = CLAMP(t, 0.0, 1.0);
+
+    opacity = t < 1.0 ? fade.from + (fade.to - fade.from) * ease(t, fade.to > fade.from)
+                      : fade.to;
+    if (!alpha_apply(surf, opacity, TRUE))
+        gtk_widget_queue_draw(widget);
+
+    if (t < 1.0)
+        return G_SOURCE_CONTINUE;
+
+    surf->tick_id = 0;
+    if (fade.to <= 0.0) {
+        surface_unmap(surf);
+        peek_ws = 0;
+        idle_arm();
+    } else if (stats.fade_pending) {
+        stats.fade_pending = FALSE;
+        stat_record(LAT_FADE, g_get_monotonic_time() - stats.t0_us);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+static void surface_start_fade(Surface *surf, gpointer data)
+{
+    (void)data;
+    if (!surf->tick_id)
+        surf->tick_id = gtk_widget_add_tick_callback(surf->da, fade_tick, surf, NULL);
+}
+
+static void fade_stop(void)
+{
+    GHashTableIter it;
+    gpointer       value;
+    g_hash_table_iter_init(&it, surfaces);
+    while (g_hash_table_iter_next(&it, NULL, &value)) {
+        Surface *surf = value;
+        if (surf->tick_id) {
+            gtk_widget_remove_tick_callback(surf->da, surf->tick_id);
+            surf->tick_id = 0;
+        }
+    }
+}
+
+static void fade_to(double target, int ms)
+{
+    fade.from     = opacity;
+    fade.to       = target;
+    fade.start_us = g_get_monotonic_time();
+    fade.dur_us   = (gint64)ms * 1000;
+    foreach_visible(surface_start_fade, NULL);
+}
+
+/* ── Show / hide ─────────────────────────────────────────────────── */
+
+static gboolean begin_hide(gpointer data)
+{
+    (void)data;
+    tid_hide = 0;
+    fade_to(0.0, FADE_OUT_MS);
+    return G_SOURCE_REMOVE;
+}
+
+static void show_indicator(void)
+{
+    if (shown_ws() < 1) return;       /* skip special workspaces */
+
+    if (tid_hide) { g_source_remove(tid_hide); tid_hide = 0; }
+    fade_stop();
+    idle_disarm();
+
+    if (!all_outputs) {
+        Surface *surf = focused_surface();
+        if (!surf) return;
+
+        /* Focus moved mid-display: drop the pill from the old output. */
+        if (cur_surf && cur_surf != surf)
+            surface_unmap(cur_surf);
+        cur_surf = surf;
+    }
+
+    stats.shows++;
+    stats.draw_pending = stats.fade_pending = TRUE;
+
+    resize_da();
+    foreach_visible(surface_map, NULL);
+    foreach_visible(surface_queue_draw, NULL);
+    fade_to(1.0, FADE_IN_MS);
+    tid_hide = g_timeout_add(DISPLAY_MS, begin_hide, NULL);
+}
+
+/* ── Trigger ─────────────────────────────────────────────────────── */
+
+/*
+ * Leading edge: the event handlers have already applied the payload to
+ * the model, so the show runs from an idle ahead of GDK's redraw and the
+ * new workspace is on screen the very next frame.  Every event in a
+ * burst lands in the same idle, and later ones only move the dot of a
+ * pill that is already up; the frame clock coalesces those redraws.
+ *
+ * Trailing edge: a handler that had to guess (a payload without the
+ * monitor, an output not seen yet) arms a reconcile; once the burst has
+ * been quiet for RECONCILE_MS the model is checked against the
+ * compositor, and the pill is repainted only if that corrected something
+ * visible.  Events that carry everything they need cost no IPC at all.
+ */
+
+static gboolean do_show(gpointer data)
+{
+    (void)data;
+    idle_show = 0;
+    stat_record(LAT_SHOW, g_get_monotonic_time() - stats.t0_us);
+    show_indicator();
+    return G_SOURCE_REMOVE;
+}
+
+/* The strip was re-laid out; repaint only if it differs from the raster. */
+static void surface_redraw_if_stale(Surface *surf, gpointer data)
+{
+    guint64 *changed = data;
+    if (memcmp(&surf->strip, &surf->pill.strip, sizeof surf->strip) == 0) return;
+
+    if (changed) (*changed)++;
+    gtk_widget_queue_draw(surf->da);
+}
+
+/* Model changed without a switch (window counts): update a visible pill in place. */
+static void pill_refresh(void)
+{
+    if (opacity <= 0.0) return;       /* re-laid out on the next show anyway */
+    resize_da();
+    foreach_visible(surface_redraw_if_stale, NULL);
+}
+
+static gboolean do_reconcile(gpointer data)
+{
+    (void)data;
+    tid_rcnc = 0;
+
+    model_resync();
+    resize_da();
+    foreach_visible(surface_redraw_if_stale, &stats.reconciles);
+    return G_SOURCE_REMOVE;
+}
+
+static void sched_show(void)
+{
+    if (!idle_show) {
+        stats.t0_us = stats.rx_us ? stats.rx_us : g_get_monotonic_time();
+        idle_show   = g_idle_add_full(G_PRIORITY_HIGH_IDLE, do_show, NULL, NULL);
+    }
+
+    /* A pending reconcile waits for the burst to go quiet. */
+    if (tid_rcnc) sched_reconcile();
+}
+
+static void sched_reconcile(void)
+{
+    if (tid_rcnc) g_source_remove(tid_rcnc);
+    tid_rcnc = g_timeout_add(RECONCILE_MS, do_reconcile, NULL);
+}
+
+/* ── socket2 reader ──────────────────────────────────────────────── */
+
+/*
+ * The event socket is a non-blocking fd watched from the GTK main loop,
+ * so events are applied to the model where they are read and every
+ * global in this file is only ever touched from one thread (the startup
+ * worker aside, which is joined before the main loop runs).
+ *
+ * While disconnected, inotify on $XDG_RUNTIME_DIR/hypr/ reports a new
+ * instance directory or socket the moment Hyprland creates it, and the
+ * reconnect runs right then.  A doubling back-off timer is only the
+ * fallback (no inotify, legacy /tmp/hypr), so a long-gone compositor
+ * costs a wakeup every RECONNECT_MAX_MS rather than every second.
+ */
+static struct {
+    int      fd;
+    guint    watch;                   /* fd source while connected */
+    guint    retry;                   /* reconnect timer or idle */
+    guint    backoff_ms;              /* last retry delay, 0 = reset */
+    int      ino;                     /* runtime-dir inotify while disconnected */
+    guint    ino_watch;
+    int      wd_runtime, wd_root;     /* $XDG_RUNTIME_DIR, …/hypr */
+    S2Reader rd;                      /* line splitter + ipc_events[] dispatch */
+} ipc = { .fd = -1, .ino = -1, .wd_runtime = -1, .wd_root = -1 };
+
+static gboolean ipc_connect(gpointer data);
+
+static char *find_socket2(void)
+{
+    return find_hypr_socket(".socket2.sock");
+}
+
+static void ipc_retry_now(void)
+{
+    if (ipc.retry) g_source_remove(ipc.retry);
+    ipc.backoff_ms = 0;
+    ipc.retry      = g_idle_add(ipc_connect, NULL);
+}
+
+static void runtime_watch_dir(const char *dir)
+{
+    if (inotify_add_watch(ipc.ino, dir, IN_CREATE | IN_MOVED_TO | IN_ONLYDIR) < 0)
+        g_debug("workspace-indicator: not watching %s: %s", dir, g_strerror(errno));
+}
+
+/* …/hypr itself, and every instance directory already in it. */
+static void runtime_watch_root(void)
+{
+    char *root = g_build_filename(g_get_user_runtime_dir(), "hypr", NULL);
+    ipc.wd_root = inotify_add_watch(ipc.ino, root, IN_CREATE | IN_MOVED_TO | IN_ONLYDIR);
+
+    GDir       *dir = ipc.wd_root >= 0 ? g_dir_open(root, 0, NULL) : NULL;
+    const char *name;
+    while (dir && (name = g_dir_read_name(dir))) {
+        char *inst = g_build_filename(root, name, NULL);
+        runtime_watch_dir(inst);
+        g_free(inst);
+    }
+    if (dir) g_dir_close(dir);
+    g_free(root);
+}
+
+static gboolean on_runtime_event(gint fd, GIOCondition cond, gpointer data)
+{
+    (void)cond; (void)data;
+    char     buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    gboolean retry = FALSE;
+    ssize_t  n;
+
+    while ((n = read(fd, buf, sizeof buf)) > 0) {
+        for (char *p = buf; p < buf + n; ) {
+            const struct inotify_event *ev = (const struct inotify_event *)p;
+            p += sizeof *ev + ev->len;
+            if (!ev->len) continue;
+
+            if (ev->wd == ipc.wd_runtime) {
+                /* First Hyprland since login: the hypr/ dir itself appears. */
+                if (g_str_equal(ev->name, "hypr") && ipc.wd_root < 0) {
+                    runtime_watch_root();
+                    retry = TRUE;
+                }
+            } else if (ev->wd == ipc.wd_root) {
+                /* New instance: its sockets follow, watch for them too. */
+                char *root = g_build_filename(g_get_user_runtime_dir(), "hypr", ev->name, NULL);
+                runtime_watch_dir(root);
+                g_free(root);
+                retry = TRUE;
+            } else if (g_str_equal(ev->name, ".socket2.sock")) {
+                retry = TRUE;
+            }
+        }
+    }
+    if (retry) ipc_retry_now();
+    return G_SOURCE_CONTINUE;
+}
+
+static void runtime_watch(void)
+{
+    if (ipc.ino >= 0) return;
+    ipc.ino = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (ipc.ino < 0) {
+        g_debug("workspace-indicator: inotify: %s", g_strerror(errno));
+        return;                       /* back-off alone */
+    }
+    ipc.wd_runtime = inotify_add_watch(ipc.ino, g_get_user_runtime_dir(),
+                                       IN_CREATE | IN_MOVED_TO | IN_ONLYDIR);
+    runtime_watch_root();
+    ipc.ino_watch = g_unix_fd_add(ipc.ino, G_IO_IN, on_runtime_event, NULL);
+}
+
+static void runtime_unwatch(void)
+{
+    if (ipc.ino < 0) return;
+    g_source_remove(ipc.ino_watch);
+    close(ipc.ino);
+    ipc.ino        = -1;
+    ipc.ino_watch  = 0;
+    ipc.wd_runtime = ipc.wd_root = -1;
+}
+
+static void ipc_schedule_reconnect(void)
+{
+    runtime_watch();
+    if (ipc.retry) return;
+    ipc.backoff_ms = ipc.backoff_ms ? MIN(ipc.backoff_ms * 2, RECONNECT_MAX_MS)
+                                    : RECONNECT_MIN_MS;
+    ipc.retry = g_timeout_add(ipc.backoff_ms, ipc_connect, NULL);
+}
+
+static gboolean on_ipc_readable(gint fd, GIOCondition cond, gpointer data)
+{
+    (void)cond; (void)data;
+
+    stats.rx_us = g_get_monotonic_time();
+    for (;;) {
+        size_t  avail;
+        char   *dst = s2_reader_space(&ipc.rd, &avail);
+        ssize_t n   = read(fd, dst, avail);
+        if (n > 0) {
+            s2_reader_commit(&ipc.rd, (size_t)n);
             continue;
         }
+        if (n < 0 && errno == EINTR)  continue;
+        if (n < 0 && errno == EAGAIN) {
+            stat_record(LAT_READ, g_get_monotonic_time() - stats.rx_us);
+            stats.rx_us = 0;
+            return G_SOURCE_CONTINUE;
+        }
+        break;                        /* EOF or hard error */
+    }
+
+    stats.rx_us = 0;
+    close(ipc.fd);
+    ipc.fd    = -1;
+    ipc.watch = 0;
+    ipc_schedule_reconnect();
+    return G_SOURCE_REMOVE;
+}
+
+static void ipc_watch(void)
+{
+    ipc.watch = g_unix_fd_add(ipc.fd, G_IO_IN | G_IO_HUP | G_IO_ERR,
+                              on_ipc_readable, NULL);
+}
+
+static gboolean ipc_connect(gpointer data)
+{
+    (void)data;
+    static gboolean warned = FALSE;
+
+    ipc.retry = 0;
+    char *path = find_socket2();
+    ipc.fd = path ? hypr_connect(path) : -1;
+
+    /* Nobody home: the compositor may be back under a new signature. */
+    if (ipc.fd < 0 && hypr_instance_refresh()) {
+        g_free(path);
+        path   = find_socket2();
+        ipc.fd = path ? hypr_connect(path) : -1;
+    }
+
+    if (!path) {
+        if (!warned)
+            g_warning("workspace-indicator: cannot locate Hyprland socket2");
+        warned = TRUE;
+        ipc_schedule_reconnect();
+        return G_SOURCE_REMOVE;
+    }
+    g_free(path);
+    if (ipc.fd < 0 || !g_unix_set_fd_nonblocking(ipc.fd, TRUE, NULL)) {
+        if (ipc.fd >= 0) close(ipc.fd);
+        ipc.fd = -1;
+        ipc_schedule_reconnect();
+        return G_SOURCE_REMOVE;
+    }
+
+    warned         = FALSE;
+    ipc.backoff_ms = 0;
+    runtime_unwatch();
+    s2_reader_reset(&ipc.rd);
+
+    /* Connected: one full resync, then events keep the model current. */
+    model_resync();
+    windows_seed();
+    pill_refresh();
+    ipc_watch();
+    return G_SOURCE_REMOVE;
+}
+
+/* ── GTK window construction ─────────────────────────────────────── */
+
+static void on_realize(GtkWidget *widget, gpointer data)
+{
+    (void)data;
+    /* Empty input region → click-through */
+    cairo_region_t *rgn = cairo_region_create();
+    gtk_widget_input_shape_combine_region(widget, rgn);
+    cairo_region_destroy(rgn);
+}
+
+static Surface *surface_new(GdkMonitor *monitor)
+{
+    Surface *surf = g_new0(Surface, 1);
+    surf->monitor = monitor;
+    surf->mon_id  = -1;
+
+    GtkWidget *win = surf->win = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+    gtk_widget_set_app_paintable(win, TRUE);
+
+    GdkScreen *scr = gtk_widget_get_screen(win);
+    GdkVisual *vis = gdk_screen_get_rgba_visual(scr);
+    if (vis) gtk_widget_set_visual(win, vis);
+
+    gtk_layer_init_for_window(GTK_WINDOW(win));
+    gtk_layer_set_monitor(GTK_WINDOW(win), monitor);
+    gtk_layer_set_layer(GTK_WINDOW(win), GTK_LAYER_SHELL_LAYER_OVERLAY);
+    gtk_layer_set_anchor(GTK_WINDOW(win), GTK_LAYER_SHELL_EDGE_BOTTOM, TRUE);
+    gtk_layer_set_margin(GTK_WINDOW(win), GTK_LAYER_SHELL_EDGE_BOTTOM, MARGIN_BOTTOM);
+    gtk_layer_set_namespace(GTK_WINDOW(win), "workspace-indicator");
+    gtk_layer_set_keyboard_mode(GTK_WINDOW(win),
+                                GTK_LAYER_SHELL_KEYBOARD_MODE_NONE);
+
+    surf->da = gtk_drawing_area_new();
+    g_signal_connect(surf->da, "draw", G_CALLBACK(on_draw), surf);
+    gtk_container_add(GTK_CONTAINER(win), surf->da);
+
+    g_signal_connect(win, "realize", G_CALLBACK(on_realize), NULL);
+
+    /* Realized but unmapped until the first show. */
+    gtk_widget_show(surf->da);
+    gtk_widget_realize(win);
+    return surf;
+}
+
+static void surface_free(gpointer data)
+{
+    Surface *surf = data;
+    if (surf == cur_surf) cur_surf = NULL;
+    alpha_release(surf);
+    gtk_widget_destroy(surf->win);
+    g_clear_pointer(&surf->pill.surf, cairo_surface_destroy);
+    g_free(surf);
+}
+
+static void on_monitor_added(GdkDisplay *display, GdkMonitor *monitor, gpointer data)
+{
+    (void)display; (void)data;
+    g_hash_table_insert(surfaces, monitor, surface_new(monitor));
+    out_map_rebuild();
+    resize_da();
+}
+
+static void on_monitor_removed(GdkDisplay *display, GdkMonitor *monitor, gpointer data)
+{
+    (void)display; (void)data;
+    g_hash_table_remove(surfaces, monitor);
+    out_map_rebuild();
+}
+
+static void build_surfaces(void)
+{
+    surfaces = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, surface_free);
+
+    GdkDisplay *display = gdk_display_get_default();
+    int n = gdk_display_get_n_monitors(display);
+    for (int i = 0; i < n; i++) {
+        GdkMonitor *monitor = gdk_display_get_monitor(display, i);
+        g_hash_table_insert(surfaces, monitor, surface_new(monitor));
+    }
+
+    g_signal_connect(display, "monitor-added",
+                     G_CALLBACK(on_monitor_added), NULL);
+    g_signal_connect(display, "monitor-removed",
+                     G_CALLBACK(on_monitor_removed), NULL);
+
+    resize_da();
+}
+
+/* ── Single-instance lock ────────────────────────────────────────── */
+
+static int acquire_lock(void)
+{
+    const char *cache = g_get_user_cache_dir();
+    char *dir  = g_build_filename(cache, "workspace-indicator", NULL);
+    g_mkdir_with_parents(dir, 0755);
+    char *path = g_build_filename(dir, "lock", NULL);
+    int fd = open(path, O_CREAT | O_RDWR, 0644);
+    g_free(dir);
+    g_free(path);
+    if (fd < 0) return -1;
+    if (flock(fd, LOCK_EX | LOCK_NB) < 0) return -1;
+    return fd;
+}
+
+/* ── Palette watch ───────────────────────────────────────────────── */
+
+/*
+ * theme-set swaps ~/.config/current/theme (a symlink) to the new theme
+ * directory; palettes can also be edited in place.  inotify on the parent
+ * catches the swap, a second watch on the resolved theme directory
+ * catches writes to hyprland-palette.conf, and a burst of either is
+ * folded into one reload on the next idle.  On a fresh install current/
+ * does not exist until the first theme-set, so ~/.config is watched for
+ * it and the watch moves down once it appears.
+ */
+static struct {
+    int   fd;
+    int   wd_config;                  /* ~/.config, only while current/ is missing */
+    int   wd_current;                 /* ~/.config/current */
+    int   wd_theme;                   /* what current/theme points at now */
+    guint idle;
+} pwatch = { .fd = -1, .wd_config = -1, .wd_current = -1, .wd_theme = -1 };
+
+static void palette_reload(void)
+{
+    if (load_palette())
+        foreach_visible(surface_queue_draw, NULL);
+}
+
+static gboolean do_palette_reload(gpointer data)
+{
+    (void)data;
+    pwatch.idle = 0;
+    palette_reload();
+    return G_SOURCE_REMOVE;
+}
+
+static void palette_watch_theme(void)
+{
+    char *dir = g_build_filename(g_get_user_config_dir(), "current", "theme", NULL);
+
+    if (pwatch.wd_theme >= 0)
+        inotify_rm_watch(pwatch.fd, pwatch.wd_theme);
+    /* Follows the symlink, so this watches the theme directory itself. */
+    pwatch.wd_theme = inotify_add_watch(pwatch.fd, dir,
+                                        IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE |
+                                        IN_DELETE_SELF | IN_ONLYDIR);
+    g_free(dir);
+}
+
+/* Watch current/ if it exists, otherwise ~/.config for its creation. */
+static gboolean palette_watch_current(void)
+{
+    char *current = g_build_filename(g_get_user_config_dir(), "current", NULL);
+    pwatch.wd_current = inotify_add_watch(pwatch.fd, current,
+                                          IN_CREATE | IN_MOVED_TO | IN_ONLYDIR);
+    if (pwatch.wd_current >= 0) {
+        if (pwatch.wd_config >= 0)
+            inotify_rm_watch(pwatch.fd, pwatch.wd_config);
+        pwatch.wd_config = -1;
+    } else if (pwatch.wd_config < 0) {
+        pwatch.wd_config = inotify_add_watch(pwatch.fd, g_get_user_config_dir(),
+                                             IN_CREATE | IN_MOVED_TO | IN_ONLYDIR);
+        if (pwatch.wd_config < 0)
+            g_message("workspace-indicator: not watching %s: %s", current, g_strerror(errno));
+    }
+    g_free(current);
+    return pwatch.wd_current >= 0;
+}
+
+static gboolean on_palette_event(gint fd, GIOCondition cond, gpointer data)
+{
+    (void)cond; (void)data;
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    gboolean reload = FALSE;
+
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof buf)) > 0) {
+        for (char *p = buf; p < buf + n; ) {
+            const struct inotify_event *ev = (const struct inotify_event *)p;
+            p += sizeof *ev + ev->len;
+
+            if (ev->wd == pwatch.wd_config) {
+                /* First theme-set: current/ appears, follow it down. */
+                if (ev->len && g_str_equal(ev->name, "current") && palette_watch_current()) {
+                    palette_watch_theme();
+                    reload = TRUE;
+                }
+            } else if (ev->wd == pwatch.wd_current) {
+                if (ev->mask & IN_IGNORED) {
+                    pwatch.wd_current = -1;     /* removed: wait for it again */
+                    palette_watch_current();
+                } else if (ev->len && g_str_equal(ev->name, "theme")) {
+                    palette_watch_theme();
+                    reload = TRUE;
+                }
+            } else if (ev->wd == pwatch.wd_theme) {
+                if (ev->mask & IN_IGNORED)
+                    pwatch.wd_theme = -1;
+                else if (ev->len && g_str_equal(ev->name, "hyprland-palette.conf"))
+                    reload = TRUE;
+            }
+        }
+    }
+
+    if (reload && !pwatch.idle)
+        pwatch.idle = g_idle_add(do_palette_reload, NULL);
+    return G_SOURCE_CONTINUE;
+}
+
+static void palette_watch_init(void)
+{
+    pwatch.fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (pwatch.fd < 0) {
+        g_warning("workspace-indicator: inotify: %s", g_strerror(errno));
+        return;
+    }
+
+    palette_watch_current();
+    palette_watch_theme();
+    g_unix_fd_add(pwatch.fd, G_IO_IN, on_palette_event, NULL);
+}
+
+/* ── Stats dump ──────────────────────────────────────────────────── */
+
+static void stats_format(GString *out)
+{
+    g_string_append_printf(out, "%-8s %10s %10s %10s %10s\n",
+                           "stage", "n", "p50 ms", "p99 ms", "max ms");
+    for (int i = 0; i < N_LAT; i++) {
+        const Hist *h = &stats.hist[i];
+        g_string_append_printf(out, "%-8s %10" G_GUINT64_FORMAT " %10.2f %10.2f %10.2f\n",
+                               lat_names[i], h->n,
+                               hist_percentile(h, 0.50) / 1000.0,
+                               hist_percentile(h, 0.99) / 1000.0,
+                               h->max_us / 1000.0);
+    }
+    g_string_append_printf(out,
+        "events %" G_GUINT64_FORMAT " (%" G_GUINT64_FORMAT " handled)  "
+        "shows %" G_GUINT64_FORMAT "  redraws %" G_GUINT64_FORMAT "  "
+        "reconcile fixes %" G_GUINT64_FORMAT "\n"
+        "ipc queries %" G_GUINT64_FORMAT " (%" G_GUINT64_FORMAT " failed)  "
+        "pill cache %u hit / %u miss\n",
+        (guint64)ipc.rd.lines, (guint64)ipc.rd.dispatched,
+        stats.shows, stats.redraws, stats.reconciles,
+        stats.ipc_queries, stats.ipc_failures,
+        pill_hits, pill_misses);
+}
+
+static void stats_dump(void)
+{
+    GString *out = g_string_new("workspace-indicator: stats\n");
+    stats_format(out);
+    fputs(out->str, stderr);
+    g_string_free(out, TRUE);
+}
+
+/* ── Control socket ──────────────────────────────────────────────── */
+
+/*
+ * $XDG_RUNTIME_DIR/workspace-indicator.sock, one command per connection:
+ * the client writes a line, the daemon answers and closes.  This is what
+ * `workspace-indicator ctl <command>` speaks, and it replaces pkill-style
+ * signalling, which scans /proc and can hit the wrong process.
+ *
+ *   peek              show the pill for the current workspace
+ *   show <ws>         show the pill with <ws> highlighted
+ *   reload-palette    re-read the theme colours
+ *   stats             latency histograms and counters
+ *   state             model snapshot
+ */
+enum { CTL_LINE_MAX = 256, CTL_TIMEOUT_MS = 1000 };
+
+typedef struct {
+    int      fd;
+    guint    watch;
+    guint    timeout;                 /* drops a client that stalls either way */
+    GString *in, *out;
+    gsize    sent;                    /* bytes of out already written */
+} CtlClient;
+
+static int      ctl_fd        = -1;
+static gboolean ctl_activated = FALSE;  /* fd came from systemd; path is not ours */
+static gboolean ctl_owned     = FALSE;  /* we bound the path, so we unlink it */
+
+static char *ctl_socket_path(void)
+{
+    return g_build_filename(g_get_user_runtime_dir(), "workspace-indicator.sock", NULL);
+}
+
+static void ctl_state(GString *out)
+{
+    g_string_append_printf(out, "workspace %d\n", cur_ws);
+    if (peek_ws > 0)
+        g_string_append_printf(out, "showing %d\n", peek_ws);
+    g_string_append_printf(out, "focused %s\n",
+                           focused_mon >= 0 ? mons[focused_mon].name : "-");
+    g_string_append(out, "occupied");
+    for (int ws = wsset_next(&wss, 0); ws; ws = wsset_next(&wss, ws))
+        g_string_append_printf(out, " %d", ws);
+    g_string_append_c(out, '\n');
+
+    for (int i = 0; i < n_mons; i++) {
+        const WsSet *v = mon_view(mons[i].id, FALSE);
+        g_string_append_printf(out, "monitor %s active %d:", mons[i].name, mons[i].active_ws);
+        for (int ws = v ? wsset_next(v, 0) : 0; ws; ws = wsset_next(v, ws))
+            g_string_append_printf(out, " %d", ws);
+        g_string_append_c(out, '\n');
+    }
+    g_string_append_printf(out, "opacity %.2f\n", opacity);
+}
+
+static void ctl_exec(char *line, GString *out)
+{
+    char *arg = strchr(line, ' ');
+    if (arg) *arg++ = '\0';
+
+    if (g_str_equal(line, "peek")) {
+        sched_show();
+        g_string_append(out, "ok\n");
+    } else if (g_str_equal(line, "show") && arg) {
+        int ws = atoi(arg);
+        if (ws < 1 || ws >= WSSET_ID_LIMIT) {
+            g_string_append_printf(out, "error: workspace out of range 1..%d\n", WSSET_ID_LIMIT - 1);
+            return;
+        }
+        peek_ws = ws;
+        sched_show();
+        g_string_append(out, "ok\n");
+    } else if (g_str_equal(line, "reload-palette")) {
+        palette_reload();
+        g_string_append(out, "ok\n");
+    } else if (g_str_equal(line, "stats")) {
+        stats_format(out);
+    } else if (g_str_equal(line, "state")) {
+        ctl_state(out);
+    } else {
+        g_string_append_printf(out, "error: unknown command '%s'\n", line);
+    }
+}
 
-        char buf[BUF_SZ], line[BUF_SZ];
-        size_t llen = 0;
-        ssize_t n;
-
-        while ((n = read(fd, buf, sizeof buf - 1)) > 0) {
-            buf[n] = '\0';
-            for (ssize_t i = 0; i < n; i++) {
-                if (buf[i] == '\n') {
-                    line[llen] = '\0';
-                    if (g_str_has_prefix(line, "workspace>>") ||
-                        g_str_has_prefix(line, "focusedmon>>"))
-                        trigger();
-                    llen = 0;
-                } else if (llen < sizeof line - 1) {
-                    line[llen++] = buf[i];
-                }
-            }
+static void ctl_client_free(CtlClient *cl)
+{
+    if (cl->watch)   g_source_remove(cl->watch);
+    if (cl->timeout) g_source_remove(cl->timeout);
+    close(cl->fd);
+    g_string_free(cl->in, TRUE);
+    if (cl->out) g_string_free(cl->out, TRUE);
+    g_free(cl);
+}
+
+static gboolean on_ctl_timeout(gpointer data)
+{
+    CtlClient *cl = data;
+    cl->timeout = 0;
+    g_debug("workspace-indicator: control client timed out");
+    ctl_client_free(cl);
+    return G_SOURCE_REMOVE;
+}
+
+/* Write what the socket takes; TRUE once the reply is out or the peer gone. */
+static gboolean ctl_client_flush(CtlClient *cl)
+{
+    while (cl->sent < cl->out->len) {
+        ssize_t w = send(cl->fd, cl->out->str + cl->sent, cl->out->len - cl->sent,
+                         MSG_NOSIGNAL);
+        if (w < 0 && errno == EINTR) continue;
+        if (w < 0 && errno == EAGAIN) return FALSE;
+        if (w <= 0) {
+            g_debug("workspace-indicator: control reply: %s", g_strerror(errno));
+            return TRUE;
         }
-        close(fd);
-        sleep(1);   /* reconnect back-off */
+        cl->sent += (gsize)w;
+    }
+    return TRUE;
+}
+
+static gboolean on_ctl_writable(gint fd, GIOCondition cond, gpointer data)
+{
+    (void)fd; (void)cond;
+    CtlClient *cl = data;
+    if (!ctl_client_flush(cl))
+        return G_SOURCE_CONTINUE;
+
+    cl->watch = 0;
+    ctl_client_free(cl);
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean on_ctl_client(gint fd, GIOCondition cond, gpointer data)
+{
+    (void)cond;
+    CtlClient *cl = data;
+    char       buf[CTL_LINE_MAX];
+    ssize_t    n  = read(fd, buf, sizeof buf);
+
+    if (n < 0 && (errno == EAGAIN || errno == EINTR))
+        return G_SOURCE_CONTINUE;
+    if (n > 0)
+        g_string_append_len(cl->in, buf, n);
+
+    char *nl = memchr(cl->in->str, '\n', cl->in->len);
+    if (!nl && n > 0 && cl->in->len < CTL_LINE_MAX)
+        return G_SOURCE_CONTINUE;     /* command still in flight */
+
+    if (nl) g_string_truncate(cl->in, (gsize)(nl - cl->in->str));
+    if (cl->in->len > 0 && cl->in->len < CTL_LINE_MAX) {
+        cl->out = g_string_new(NULL);
+        ctl_exec(cl->in->str, cl->out);
+
+        /* `state` and `stats` grow with the model and can outrun the
+         * socket buffer: finish on G_IO_OUT, still under the timeout. */
+        if (!ctl_client_flush(cl)) {
+            cl->watch = g_unix_fd_add(fd, G_IO_OUT, on_ctl_writable, cl);
+            return G_SOURCE_REMOVE;
+        }
+    }
+
+    cl->watch = 0;
+    ctl_client_free(cl);
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean on_ctl_accept(gint fd, GIOCondition cond, gpointer data)
+{
+    (void)cond; (void)data;
+
+    int cfd;
+    while ((cfd = accept4(fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+        CtlClient *cl = g_new0(CtlClient, 1);
+        cl->fd    = cfd;
+        cl->in    = g_string_sized_new(64);
+        cl->watch   = g_unix_fd_add(cfd, G_IO_IN | G_IO_HUP | G_IO_ERR, on_ctl_client, cl);
+        cl->timeout = g_timeout_add(CTL_TIMEOUT_MS, on_ctl_timeout, cl);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+/*
+ * systemd socket activation: LISTEN_PID/LISTEN_FDS hand over the control
+ * socket already bound and listening as fd 3, possibly with the
+ * connection that started us queued on it.  Must run before any thread
+ * exists, since it edits the environment.
+ */
+enum { SD_LISTEN_FDS_START = 3 };
+
+static void ctl_inherit(void)
+{
+    const char *pid = g_getenv("LISTEN_PID");
+    const char *fds = g_getenv("LISTEN_FDS");
+    if (!pid || !fds || atol(pid) != (long)getpid() || atoi(fds) < 1)
+        return;
+
+    g_unsetenv("LISTEN_PID");
+    g_unsetenv("LISTEN_FDS");
+    g_unsetenv("LISTEN_FDNAMES");
+
+    int       fd = SD_LISTEN_FDS_START, listening = 0;
+    socklen_t len = sizeof listening;
+    if (getsockopt(fd, SOL_SOCKET, SO_ACCEPTCONN, &listening, &len) < 0 || !listening) {
+        g_warning("workspace-indicator: inherited fd %d is not a listening socket", fd);
+        return;
+    }
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    g_unix_set_fd_nonblocking(fd, TRUE, NULL);
+    ctl_fd        = fd;
+    ctl_activated = TRUE;
+}
+
+/*
+ * Activated while another instance holds the lock (one started by hand):
+ * accept and answer whatever is queued, or systemd would re-trigger the
+ * service on the still-readable socket until it hits the trigger limit.
+ * The client sees why instead of an empty reply.
+ */
+static void ctl_refuse(void)
+{
+    static const char msg[] = "error: another instance holds the lock\n";
+    if (!ctl_activated) return;
+
+    int cfd;
+    while ((cfd = accept4(ctl_fd, NULL, NULL, SOCK_CLOEXEC)) >= 0) {
+        if (send(cfd, msg, sizeof msg - 1, MSG_NOSIGNAL | MSG_DONTWAIT) < 0)
+            g_debug("workspace-indicator: refuse: %s", g_strerror(errno));
+        close(cfd);
+    }
+    close(ctl_fd);
+    ctl_fd = -1;
+}
+
+/*
+ * Something is already at the control path: either a crashed instance's
+ * leftover or, when we were started by hand, the listener of
+ * workspace-indicator.socket.  Only a refused connect means stale; the
+ * socket unit's path is how `ctl` starts the service and must survive us.
+ */
+static gboolean ctl_path_stale(const struct sockaddr_un *addr)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return FALSE;
+
+    gboolean stale = connect(fd, (const struct sockaddr *)addr, sizeof *addr) < 0 &&
+                     errno == ECONNREFUSED;
+    close(fd);
+    return stale;
+}
+
+static void ctl_listen(void)
+{
+    if (ctl_activated) {
+        g_unix_fd_add(ctl_fd, G_IO_IN, on_ctl_accept, NULL);
+        return;
     }
 
+    char *path = ctl_socket_path();
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    g_strlcpy(addr.sun_path, path, sizeof addr.sun_path);
+
+    ctl_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int rc = ctl_fd < 0 ? -1 : bind(ctl_fd, (struct sockaddr *)&addr, sizeof addr);
+    if (rc < 0 && errno == EADDRINUSE) {
+        if (!ctl_path_stale(&addr)) {
+            g_message("workspace-indicator: %s has a live listener "
+                      "(workspace-indicator.socket?); control socket disabled", path);
+            close(ctl_fd);
+            ctl_fd = -1;
+            g_free(path);
+            return;
+        }
+        unlink(path);
+        rc = bind(ctl_fd, (struct sockaddr *)&addr, sizeof addr);
+    }
+    if (rc == 0) ctl_owned = TRUE;
+
+    if (rc < 0 || chmod(path, 0600) < 0 || listen(ctl_fd, 8) < 0) {
+        g_warning("workspace-indicator: control socket %s: %s", path, g_strerror(errno));
+        if (ctl_owned) unlink(path);
+        if (ctl_fd >= 0) close(ctl_fd);
+        ctl_fd    = -1;
+        ctl_owned = FALSE;
+        g_free(path);
+        return;
+    }
     g_free(path);
-    return NULL;
+    g_unix_fd_add(ctl_fd, G_IO_IN, on_ctl_accept, NULL);
 }
 
-/* ── GTK window construction ─────────────────────────────────────── */
+static void ctl_unlisten(void)
+{
+    if (ctl_fd < 0) return;
+    if (ctl_owned) {
+        char *path = ctl_socket_path();
+        unlink(path);
+        g_free(path);
+    }
+    close(ctl_fd);
+    ctl_fd = -1;
+}
 
-static void on_realize(GtkWidget *widget, gpointer data)
+/*
+ * Whether workspace-indicator.socket is installed for the user manager.
+ * If it is but not listening, spawning would race the unit's own
+ * instance for the path, so `ctl` leaves starting it to systemd.
+ */
+static gboolean ctl_socket_unit_installed(void)
 {
-    (void)data;
-    /* Empty input region → click-through */
-    cairo_region_t *rgn = cairo_region_create();
-    gtk_widget_input_shape_combine_region(widget, rgn);
-    cairo_region_destroy(rgn);
+    const char *const *data = g_get_system_data_dirs();
+    GPtrArray *dirs = g_ptr_array_new_with_free_func(g_free);
+    g_ptr_array_add(dirs, g_build_filename(g_get_user_config_dir(), "systemd", "user", NULL));
+    g_ptr_array_add(dirs, g_build_filename(g_get_user_data_dir(), "systemd", "user", NULL));
+    g_ptr_array_add(dirs, g_strdup("/etc/systemd/user"));
+    for (int i = 0; data[i]; i++)
+        g_ptr_array_add(dirs, g_build_filename(data[i], "systemd", "user", NULL));
+    g_ptr_array_add(dirs, g_strdup("/usr/lib/systemd/user"));
+
+    gboolean found = FALSE;
+    for (guint i = 0; i < dirs->len && !found; i++) {
+        char *unit = g_build_filename(dirs->pdata[i], "workspace-indicator.socket", NULL);
+        found = g_file_test(unit, G_FILE_TEST_EXISTS);
+        g_free(unit);
+    }
+    g_ptr_array_free(dirs, TRUE);
+    return found;
 }
 
-static void build_window(void)
+/*
+ * No daemon and no systemd socket to start one: for the commands that
+ * show the pill, start it ourselves and wait for its socket.
+ */
+static int ctl_spawn_daemon(const char *path)
 {
-    win = gtk_window_new(GTK_WINDOW_TOPLEVEL);
-    gtk_widget_set_app_paintable(win, TRUE);
+    char  *self = g_file_read_link("/proc/self/exe", NULL);
+    char  *args[] = { self, NULL };
+    GError *err = NULL;
+
+    if (!self || !g_spawn_async(NULL, args, NULL, G_SPAWN_STDOUT_TO_DEV_NULL,
+                                NULL, NULL, NULL, &err)) {
+        fprintf(stderr, "workspace-indicator: cannot start daemon: %s\n",
+                err ? err->message : "unknown executable");
+        g_clear_error(&err);
+        g_free(self);
+        return -1;
+    }
+    g_free(self);
 
-    GdkScreen *scr = gtk_widget_get_screen(win);
-    GdkVisual *vis = gdk_screen_get_rgba_visual(scr);
-    if (vis) gtk_widget_set_visual(win, vis);
+    for (int waited = 0; waited < SPAWN_WAIT_MS; waited += 20) {
+        g_usleep(20 * 1000);
+        int fd = hypr_connect(path);
+        if (fd >= 0) return fd;
+    }
+    return -1;
+}
 
-    gtk_layer_init_for_window(GTK_WINDOW(win));
-    gtk_layer_set_layer(GTK_WINDOW(win), GTK_LAYER_SHELL_LAYER_OVERLAY);
-    gtk_layer_set_anchor(GTK_WINDOW(win), GTK_LAYER_SHELL_EDGE_BOTTOM, TRUE);
-    gtk_layer_set_margin(GTK_WINDOW(win), GTK_LAYER_SHELL_EDGE_BOTTOM, MARGIN_BOTTOM);
-    gtk_layer_set_namespace(GTK_WINDOW(win), "workspace-indicator");
-    gtk_layer_set_keyboard_mode(GTK_WINDOW(win),
-                                GTK_LAYER_SHELL_KEYBOARD_MODE_NONE);
+/*
+ * `workspace-indicator ctl <command> [arg]` — runs before GTK or the
+ * instance lock are touched, so a keypress costs one connect + write.
+ */
+static int ctl_client_main(int argc, char *argv[])
+{
+    if (argc < 1) {
+        fprintf(stderr, "usage: workspace-indicator ctl peek|show <ws>|reload-palette|stats|state\n");
+        return 2;
+    }
 
-    da = gtk_drawing_area_new();
-    g_signal_connect(da, "draw", G_CALLBACK(on_draw), NULL);
-    gtk_container_add(GTK_CONTAINER(win), da);
+    GString *req = g_string_new(argv[0]);
+    for (int i = 1; i < argc; i++)
+        g_string_append_printf(req, " %s", argv[i]);
+    g_string_append_c(req, '\n');
+
+    char    *path  = ctl_socket_path();
+    int      fd    = hypr_connect(path);
+    gboolean shows = g_str_equal(argv[0], "peek") || g_str_equal(argv[0], "show");
+    gboolean unit  = fd < 0 && ctl_socket_unit_installed();
+    if (fd < 0 && shows && !unit)
+        fd = ctl_spawn_daemon(path);
+    if (fd < 0) {
+        fprintf(stderr, "workspace-indicator: daemon not reachable at %s%s\n", path,
+                unit ? " (is workspace-indicator.socket started?)" : "");
+        g_free(path);
+        g_string_free(req, TRUE);
+        return 1;
+    }
 
-    g_signal_connect(win, "realize", G_CALLBACK(on_realize), NULL);
+    int rc = write(fd, req->str, req->len) == (ssize_t)req->len ? 0 : 1;
+    g_string_free(req, TRUE);
+    shutdown(fd, SHUT_WR);
+
+    char    buf[BUF_SZ];
+    ssize_t n;
+    gboolean first = TRUE;
+    while ((n = read(fd, buf, sizeof buf)) > 0) {
+        if (first && n >= 6 && memcmp(buf, "error:", 6) == 0) rc = 1;
+        first = FALSE;
+        fwrite(buf, 1, (size_t)n, stdout);
+    }
+    close(fd);
 
-    bind_to_focused_monitor();
-    resize_da();
-    gtk_widget_set_opacity(win, 0.0);
-    gtk_widget_show_all(win);
+    /* Every command answers at least a line; nothing means it was dropped. */
+    if (first) {
+        fprintf(stderr, "workspace-indicator: no reply from daemon at %s\n", path);
+        rc = 1;
+    }
+    g_free(path);
+    return rc;
 }
 
-/* ── Single-instance lock ────────────────────────────────────────── */
+/* ── Headless render ─────────────────────────────────────────────── */
 
-static int acquire_lock(void)
+/*
+ * `--render-bench [-n samples] [-d fixture-dir] [-H]` times the hot paths
+ * only the GTK build has, as benchrun.h rows (-H drops the column header
+ * so they can follow hotpath-bench's; `make bench-all`):
+ *
+ *   model.socket2_line      the real ipc_events[] handlers replaying the
+ *                           fixture socket2 stream over a model seeded from
+ *                           the fixture snapshot and clients, per line
+ *   draw.raster.n<N>.x<S>   draw_pill() into an image surface — a pill-cache
+ *                           miss — per raster, over every active position
+ *   draw.frame.x<S>.o<A>    compositing a full cached raster at fade alpha
+ *                           A, i.e. one fade frame
+ *
+ * `--render-png <dir>` writes every dot count from PERSISTENT_WS to
+ * MAX_DOTS, every active position, each palette, scale and opacity below
+ * to <dir>/<palette>-n<N>-a<pos>-x<scale×10>-o<opacity×100>.png.  The
+ * palettes are compiled in, so the images are reproducible for
+ * golden-image checks.  Neither needs a display.
+ */
+typedef struct {
+    const char *name;
+    Palette     pal;
+} RenderPalette;
+
+static const double render_scales[]    = { 1.0, 1.5, 2.0 };
+static const double render_opacities[] = { 1.0, 0.6, 0.2 };
+
+/* Occupied, empty and window-count variety across the strip. */
+static void render_strip(DotStrip *d, int n, int pos)
 {
-    const char *cache = g_get_user_cache_dir();
-    char *dir  = g_build_filename(cache, "workspace-indicator", NULL);
-    g_mkdir_with_parents(dir, 0755);
-    char *path = g_build_filename(dir, "lock", NULL);
-    int fd = open(path, O_CREAT | O_RDWR, 0644);
-    g_free(dir);
+    memset(d, 0, sizeof *d);
+    d->n          = n;
+    d->active     = pos + 1;
+    d->more_right = n == MAX_DOTS;    /* full strips exercise the edge hint */
+    for (int i = 0; i < n; i++) {
+        d->ids[i]      = i + 1;
+        d->wins[i]     = (guint8)(i % (WIN_STEPS + 1));
+        d->occupied[i] = (i + 1) % 3 != 0;
+    }
+}
+
+/* One on_draw(): the raster itself when src is NULL, else src at alpha a. */
+static void render_paint(cairo_surface_t *target, cairo_surface_t *src,
+                         const DotStrip *d, int w, int h, double a)
+{
+    cairo_t *cr = cairo_create(target);
+    cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+    cairo_paint(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+    if (src) {
+        cairo_set_source_surface(cr, src, 0, 0);
+        cairo_paint_with_alpha(cr, a);
+    } else {
+        draw_pill(cr, w, h, d);
+    }
+    cairo_destroy(cr);
+    cairo_surface_flush(target);
+}
+
+static cairo_surface_t *render_target(int w, int h, double scale)
+{
+    cairo_surface_t *s = cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                                                    (int)ceil(w * scale),
+                                                    (int)ceil(h * scale));
+    cairo_surface_set_device_scale(s, scale, scale);
+    return s;
+}
+
+typedef struct {
+    cairo_surface_t *target, *pill;   /* pill: NULL to time the raster */
+    DotStrip         strips[MAX_DOTS];
+    int              n, w, h;
+    double           a;
+} DrawCase;
+
+static void b_raster(void *ctx)
+{
+    DrawCase *dc = ctx;
+    for (int pos = 0; pos < dc->n; pos++)
+        render_paint(dc->target, NULL, &dc->strips[pos], dc->w, dc->h, 1.0);
+}
+
+static void b_frame(void *ctx)
+{
+    DrawCase *dc = ctx;
+    render_paint(dc->target, dc->pill, NULL, dc->w, dc->h, dc->a);
+}
+
+static char *render_fixture(const char *dir, const char *name)
+{
+    char *path = g_build_filename(dir, name, NULL);
+    char *text = NULL;
+    if (!g_file_get_contents(path, &text, NULL, NULL))
+        fprintf(stderr, "workspace-indicator: cannot read %s\n", path);
     g_free(path);
-    if (fd < 0) return -1;
-    if (flock(fd, LOCK_EX | LOCK_NB) < 0) return -1;
-    return fd;
+    return text;
+}
+
+/*
+ * Seed the model from the fixture snapshot and clients the way
+ * startup_finish() does, and load the socket2 stream; FALSE if the
+ * fixtures are missing.  hypr_sig is unset here, so a handler that falls
+ * back to a resync fails fast instead of asking a live compositor.
+ */
+static gboolean render_model_seed(const char *dir, char **stream, gsize *lines)
+{
+    char *mons_js = render_fixture(dir, "monitors.json");
+    char *wss_js  = render_fixture(dir, "workspaces.json");
+    char *act_js  = render_fixture(dir, "activeworkspace.json");
+    char *cli_js  = render_fixture(dir, "clients.json");
+    *stream       = render_fixture(dir, "events.socket2");
+
+    gboolean ok = mons_js && wss_js && act_js && cli_js && *stream;
+    if (ok) {
+        static HyprSnapshot snap;
+        static HyprClient   clients[MAX_CLIENTS];
+        char      *batch = g_strconcat(mons_js, wss_js, act_js, NULL);
+        JsonCursor c;
+        json_cursor_init(&c, cli_js, strlen(cli_js));
+        int n = json_parse_clients(&c, clients, MAX_CLIENTS);
+
+        ok = snapshot_parse(batch, &snap) && n >= 0;
+        if (ok) {
+            model_apply(&snap);
+            windows_apply(clients, n);
+        }
+        g_free(batch);
+        g_free(snap.wss);
+    }
+    *lines = 0;
+    for (const char *p = ok ? *stream : ""; *p; p++)
+        *lines += *p == '\n';
+
+    g_free(mons_js);
+    g_free(wss_js);
+    g_free(act_js);
+    g_free(cli_js);
+    if (!ok || *lines == 0) g_clear_pointer(stream, g_free);
+    return *stream != NULL;
+}
+
+typedef struct {
+    S2Reader    rd;
+    const char *stream;
+    size_t      len;
+} ModelCase;
+
+static void b_model(void *ctx)
+{
+    ModelCase *mc = ctx;
+    s2_reader_feed(&mc->rd, mc->stream, mc->len);
+}
+
+static int render_bench(int argc, char **argv)
+{
+    const char *dir     = "bench/fixtures";
+    int         samples = 21;
+    gboolean    header  = TRUE;
+
+    for (int i = 0; i < argc; i++) {
+        if (g_str_equal(argv[i], "-n") && i + 1 < argc)      samples = atoi(argv[++i]);
+        else if (g_str_equal(argv[i], "-d") && i + 1 < argc) dir     = argv[++i];
+        else if (g_str_equal(argv[i], "-H"))                 header  = FALSE;
+        else {
+            fprintf(stderr, "usage: workspace-indicator --render-bench "
+                            "[-n samples] [-d fixture-dir] [-H]\n");
+            return 2;
+        }
+    }
+    samples = MAX(samples, 3);
+
+    printf("# workspace-indicator --render-bench fixtures=%s samples=%d\n", dir, samples);
+    if (header) bench_columns();
+
+    int rc = 0;
+
+    windows_init();
+    char     *stream;
+    gsize     lines;
+    ModelCase mc = {0};
+    if (render_model_seed(dir, &stream, &lines)) {
+        mc.stream = stream;
+        mc.len    = strlen(stream);
+        s2_reader_init(&mc.rd, ipc_events, G_N_ELEMENTS(ipc_events), BUF_SZ, NULL);
+        Bench b = { "model.socket2_line", b_model, &mc, lines };
+        if (!bench_run(&b, samples)) rc = 1;
+        s2_reader_free(&mc.rd);
+        g_free(stream);
+    } else {
+        fprintf(stderr, "workspace-indicator: no fixtures in %s, skipping model.*\n", dir);
+    }
+
+    for (size_t s = 0; s < G_N_ELEMENTS(render_scales); s++) {
+        double scale = render_scales[s];
+
+        for (int n = PERSISTENT_WS; n <= MAX_DOTS; n++) {
+            DrawCase dc = { .n = n };
+            for (int pos = 0; pos < n; pos++)
+                render_strip(&dc.strips[pos], n, pos);
+            pill_size(&dc.strips[0], &dc.w, &dc.h);
+            dc.target = render_target(dc.w, dc.h, scale);
+
+            char *name = g_strdup_printf("draw.raster.n%d.x%.1f", n, scale);
+            Bench b    = { name, b_raster, &dc, (size_t)n };
+            if (!bench_run(&b, samples)) rc = 1;
+            g_free(name);
+            cairo_surface_destroy(dc.target);
+        }
+
+        DrawCase dc = { .n = MAX_DOTS };
+        render_strip(&dc.strips[0], MAX_DOTS, MAX_DOTS / 2);
+        pill_size(&dc.strips[0], &dc.w, &dc.h);
+        dc.pill   = render_target(dc.w, dc.h, scale);
+        dc.target = render_target(dc.w, dc.h, scale);
+        render_paint(dc.pill, NULL, &dc.strips[0], dc.w, dc.h, 1.0);
+
+        for (size_t o = 0; o < G_N_ELEMENTS(render_opacities); o++) {
+            dc.a = render_opacities[o];
+            char *name = g_strdup_printf("draw.frame.x%.1f.o%.2f", scale, dc.a);
+            Bench b    = { name, b_frame, &dc, 1 };
+            if (!bench_run(&b, samples)) rc = 1;
+            g_free(name);
+        }
+        cairo_surface_destroy(dc.target);
+        cairo_surface_destroy(dc.pill);
+    }
+
+    if (rc) fprintf(stderr, "workspace-indicator: out of memory\n");
+    wsset_free(&wss);
+    return rc;
+}
+
+static int render_png(const char *png_dir)
+{
+    /* Before any load_palette(), pal still holds the compiled-in fallback. */
+    const RenderPalette palettes[] = {
+        { "fallback", pal },
+        { "light",    { { 0.937, 0.945, 0.961, 0.75 }, { 0.118, 0.400, 0.961, 1.00 },
+                        { 0.298, 0.310, 0.412, 0.55 }, { 0.612, 0.627, 0.690, 0.25 } } },
+        { "contrast", { { 0.000, 0.000, 0.000, 0.90 }, { 1.000, 0.843, 0.000, 1.00 },
+                        { 1.000, 1.000, 1.000, 0.80 }, { 0.600, 0.600, 0.600, 0.40 } } },
+    };
+
+    if (g_mkdir_with_parents(png_dir, 0755) < 0) {
+        fprintf(stderr, "workspace-indicator: %s: %s\n", png_dir, g_strerror(errno));
+        return 1;
+    }
+
+    int rc = 0, written = 0;
+    for (size_t p = 0; p < G_N_ELEMENTS(palettes); p++) {
+        pal = palettes[p].pal;
+
+        for (int n = PERSISTENT_WS; n <= MAX_DOTS; n++) {
+            for (int pos = 0; pos < n; pos++) {
+                DotStrip d;
+                render_strip(&d, n, pos);
+
+                int w, h;
+                pill_size(&d, &w, &h);
+
+                for (size_t s = 0; s < G_N_ELEMENTS(render_scales); s++) {
+                    double           scale = render_scales[s];
+                    cairo_surface_t *pill  = render_target(w, h, scale);
+                    cairo_surface_t *frame = render_target(w, h, scale);
+                    render_paint(pill, NULL, &d, w, h, 1.0);
+
+                    for (size_t o = 0; o < G_N_ELEMENTS(render_opacities); o++) {
+                        double a = render_opacities[o];
+                        render_paint(frame, pill, &d, w, h, a);
+
+                        char *path = g_strdup_printf("%s/%s-n%d-a%d-x%d-o%d.png", png_dir,
+                                                     palettes[p].name, n, pos + 1,
+                                                     (int)lround(scale * 10), (int)lround(a * 100));
+                        if (cairo_surface_write_to_png(frame, path) != CAIRO_STATUS_SUCCESS) {
+                            fprintf(stderr, "workspace-indicator: cannot write %s\n", path);
+                            rc = 1;
+                        } else {
+                            written++;
+                        }
+                        g_free(path);
+                    }
+                    cairo_surface_destroy(frame);
+                    cairo_surface_destroy(pill);
+                }
+            }
+        }
+    }
+
+    printf("workspace-indicator: wrote %d images to %s\n", written, png_dir);
+    return rc;
+}
+
+/* ── Warm state ──────────────────────────────────────────────────── */
+
+/*
+ * $XDG_RUNTIME_DIR/workspace-indicator.state: the model and palette as
+ * they were at the last exit, for an on-demand start.  Loaded before the
+ * surfaces are built, so they are sized for the right strip from the
+ * first configure and a peek can draw even before (or without) the IPC
+ * snapshot, which replaces it moments later.  Only valid for the
+ * Hyprland instance that wrote it.  Tab-separated lines:
+ *
+ *   sig      <instance signature>
+ *   palette  <16 doubles: bg, active, fg, dim as r g b a>
+ *   mon      <id> <active ws> <focused> <x> <y> <w> <h> <name> <make> <model>
+ *   ws       <id> <monitor id> <name>
+ *   active   <id>
+ */
+static char *state_path(void)
+{
+    return g_build_filename(g_get_user_runtime_dir(), "workspace-indicator.state", NULL);
+}
+
+static void state_save(void)
+{
+    const char *sig = hypr_sig;
+    if (!sig || n_mons < 1) return;
+
+    GString *out = g_string_new("workspace-indicator-state\t1\n");
+    g_string_append_printf(out, "sig\t%s\npalette", sig);
+    const RGBA *roles[] = { &pal.bg, &pal.active, &pal.fg, &pal.dim };
+    for (size_t i = 0; i < G_N_ELEMENTS(roles); i++)
+        g_string_append_printf(out, "\t%.17g\t%.17g\t%.17g\t%.17g",
+                               roles[i]->r, roles[i]->g, roles[i]->b, roles[i]->a);
+    g_string_append_c(out, '\n');
+
+    for (int i = 0; i < n_mons; i++) {
+        const HyprMonitor *m = &mons[i];
+        g_string_append_printf(out, "mon\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%s\t%s\t%s\n",
+                               m->id, m->active_ws, i == focused_mon, m->x, m->y,
+                               m->width, m->height, m->name, m->make, m->model);
+    }
+
+    GHashTable *names = g_hash_table_new(g_direct_hash, g_direct_equal);
+    GHashTableIter it;
+    gpointer       key, value;
+    g_hash_table_iter_init(&it, ws_names);
+    while (g_hash_table_iter_next(&it, &key, &value))
+        g_hash_table_insert(names, value, key);
+    for (int ws = wsset_next(&wss, 0); ws; ws = wsset_next(&wss, ws)) {
+        const char *name = g_hash_table_lookup(names, GINT_TO_POINTER(ws));
+        g_string_append_printf(out, "ws\t%d\t%d\t%s\n", ws, wsset_monitor(&wss, ws),
+                               name ? name : "");
+    }
+    g_hash_table_destroy(names);
+    g_string_append_printf(out, "active\t%d\n", cur_ws);
+
+    char   *path = state_path();
+    GError *err  = NULL;
+    if (!g_file_set_contents(path, out->str, (gssize)out->len, &err)) {
+        g_warning("workspace-indicator: %s", err->message);
+        g_error_free(err);
+    }
+    g_free(path);
+    g_string_free(out, TRUE);
+}
+
+static void state_load(void)
+{
+    static HyprSnapshot snap;
+    const char *sig  = hypr_sig;
+    char       *path = state_path();
+    char       *text = NULL;
+    gboolean    ok   = sig && g_file_get_contents(path, &text, NULL, NULL) &&
+                       g_str_has_prefix(text, "workspace-indicator-state\t1\n");
+    g_free(path);
+
+    Palette  warm = pal;
+    gboolean same = FALSE;
+    snap.n_mons    = 0;
+    snap.n_wss     = 0;
+    snap.active.id = 0;
+
+    char **lines = ok ? g_strsplit(text, "\n", -1) : NULL;
+    for (char **l = lines; l && *l; l++) {
+        char **f = g_strsplit(*l, "\t", -1);
+        guint  n = g_strv_length(f);
+
+        if (n == 2 && g_str_equal(f[0], "sig")) {
+            same = g_str_equal(f[1], sig);
+        } else if (n == 17 && g_str_equal(f[0], "palette")) {
+            RGBA *roles[] = { &warm.bg, &warm.active, &warm.fg, &warm.dim };
+            for (guint i = 0; i < G_N_ELEMENTS(roles); i++)
+                *roles[i] = (RGBA){ g_ascii_strtod(f[4 * i + 1], NULL),
+                                    g_ascii_strtod(f[4 * i + 2], NULL),
+                                    g_ascii_strtod(f[4 * i + 3], NULL),
+                                    g_ascii_strtod(f[4 * i + 4], NULL) };
+        } else if (n == 11 && g_str_equal(f[0], "mon") && snap.n_mons < MAX_MONS) {
+            HyprMonitor *m = &snap.mons[snap.n_mons++];
+            m->id        = atoi(f[1]);
+            m->active_ws = atoi(f[2]);
+            m->focused   = atoi(f[3]) != 0;
+            m->x         = atoi(f[4]);
+            m->y         = atoi(f[5]);
+            m->width     = atoi(f[6]);
+            m->height    = atoi(f[7]);
+            g_strlcpy(m->name,  f[8],  sizeof m->name);
+            g_strlcpy(m->make,  f[9],  sizeof m->make);
+            g_strlcpy(m->model, f[10], sizeof m->model);
+        } else if (n == 4 && g_str_equal(f[0], "ws")) {
+            snapshot_reserve(&snap, snap.n_wss + 1);
+            HyprWorkspace *w = &snap.wss[snap.n_wss++];
+            w->id         = atoi(f[1]);
+            w->monitor_id = atoi(f[2]);
+            g_strlcpy(w->name, f[3], sizeof w->name);
+        } else if (n == 2 && g_str_equal(f[0], "active")) {
+            snap.active.id = atoi(f[1]);
+        }
+        g_strfreev(f);
+    }
+    g_strfreev(lines);
+    g_free(text);
+
+    /* A restarted compositor starts from scratch; so do we. */
+    if (!same || snap.n_mons < 1) return;
+    palette_apply(&warm);
+    model_apply(&snap);
+}
+
+/* ── Startup pipeline ────────────────────────────────────────────── */
+
+/*
+ * Everything startup needs from outside the process — the socket2
+ * connection, the [[BATCH]] snapshot, the client list and the palette
+ * file — is fetched on a worker thread while the main thread is in
+ * gtk_init() and building surfaces.  socket2 is connected first, so
+ * events from then on queue in the socket and are read, after the
+ * snapshot they postdate, once the main loop starts.  The worker owns
+ * `boot` and (until joined) the IPC counters and req_path; socket paths
+ * are resolved before it starts since GTK init may touch the
+ * environment.  --startup-trace prints each phase to stderr.
+ */
+static gboolean startup_trace = FALSE;
+static gint64   startup_t0;
+
+static void trace(const char *phase, gint64 since)
+{
+    if (!startup_trace) return;
+    gint64 now = g_get_monotonic_time();
+    fprintf(stderr, "workspace-indicator: startup %-16s %8.2f ms  (at %8.2f ms)\n",
+            phase, (now - since) / 1000.0, (now - startup_t0) / 1000.0);
+}
+
+static struct {
+    GThread     *thread;
+    char        *s2_path;             /* inputs, resolved on the main thread */
+    char        *pal_path;
+    int          s2_fd;               /* results, valid once joined */
+    gboolean     have_snap;
+    HyprSnapshot snap;
+    HyprClient   clients[MAX_CLIENTS];
+    int          n_clients;
+    Palette      pal;
+    gboolean     have_pal;
+} boot = { .s2_fd = -1, .n_clients = -1 };
+
+static gpointer startup_worker(gpointer data)
+{
+    (void)data;
+    gint64 t = g_get_monotonic_time();
+
+    if (boot.s2_path) {
+        boot.s2_fd = hypr_connect(boot.s2_path);
+        if (boot.s2_fd >= 0 && !g_unix_set_fd_nonblocking(boot.s2_fd, TRUE, NULL)) {
+            close(boot.s2_fd);
+            boot.s2_fd = -1;
+        }
+        trace("[bg] socket2", t);
+    }
+
+    if (boot.s2_fd >= 0 && req_path) {
+        t = g_get_monotonic_time();
+        boot.have_snap = hypr_snapshot(&boot.snap);
+        if (boot.have_snap)
+            stat_record(LAT_RESYNC, g_get_monotonic_time() - t);
+        trace("[bg] snapshot", t);
+
+        t = g_get_monotonic_time();
+        boot.n_clients = windows_fetch(boot.clients, MAX_CLIENTS);
+        trace("[bg] clients", t);
+    }
+
+    t = g_get_monotonic_time();
+    boot.have_pal = palette_read(boot.pal_path, &boot.pal);
+    trace("[bg] palette", t);
+    return NULL;
+}
+
+static void startup_begin(void)
+{
+    boot.s2_path  = find_socket2();
+    boot.pal_path = palette_path();
+    boot.pal      = pal;
+    req_path      = find_hypr_socket(".socket.sock");
+    boot.thread   = g_thread_new("startup", startup_worker, NULL);
+}
+
+/* Join the worker and apply what it fetched; needs surfaces and tables. */
+static void startup_finish(void)
+{
+    gint64 t = g_get_monotonic_time();
+    g_thread_join(boot.thread);
+    boot.thread = NULL;
+    trace("join", t);
+
+    t = g_get_monotonic_time();
+    if (boot.have_pal)
+        palette_apply(&boot.pal);
+    else
+        g_message("workspace-indicator: no palette at %s, using fallback", boot.pal_path);
+
+    if (boot.s2_fd >= 0) {
+        ipc.fd = boot.s2_fd;
+        s2_reader_reset(&ipc.rd);
+        if (boot.have_snap) model_apply(&boot.snap);
+        else                model_resync();
+        g_clear_pointer(&boot.snap.wss, g_free);
+        if (boot.n_clients >= 0) windows_apply(boot.clients, boot.n_clients);
+        else                     windows_seed();
+        ipc_watch();
+    } else {
+        ipc_connect(NULL);            /* warns and retries as on any drop */
+    }
+    resize_da();
+    trace("apply", t);
+
+    g_clear_pointer(&boot.s2_path, g_free);
+    g_clear_pointer(&boot.pal_path, g_free);
 }
 
 /* ── Signals ─────────────────────────────────────────────────────── */
 
-static gboolean on_usr1(gpointer data)  { (void)data; trigger(); return G_SOURCE_CONTINUE; }
-static gboolean on_usr2(gpointer data)  { (void)data; load_palette(); return G_SOURCE_CONTINUE; }
+static gboolean on_usr1(gpointer data)  { (void)data; sched_show(); return G_SOURCE_CONTINUE; }
+static gboolean on_usr2(gpointer data)  { (void)data; palette_reload(); return G_SOURCE_CONTINUE; }
+static gboolean on_hup(gpointer data)   { (void)data; stats_dump(); return G_SOURCE_CONTINUE; }
 static gboolean on_quit(gpointer data)  { (void)data; gtk_main_quit(); return G_SOURCE_REMOVE; }
 
 /* ── main ────────────────────────────────────────────────────────── */
 
 int main(int argc, char *argv[])
 {
+    startup_t0 = g_get_monotonic_time();
+
+    if (argc > 1 && g_str_equal(argv[1], "ctl"))
+        return ctl_client_main(argc - 2, argv + 2);
+    if (argc > 1 && g_str_equal(argv[1], "--render-bench"))
+        return render_bench(argc - 2, argv + 2);
+    if (argc > 2 && g_str_equal(argv[1], "--render-png"))
+        return render_png(argv[2]);
+
+    /* Needed before gtk_init(), which is itself traced. */
+    for (int i = 1; i < argc; i++)
+        if (g_str_equal(argv[i], "--startup-trace"))
+            startup_trace = TRUE;
+
+    gint64 t = g_get_monotonic_time();
     int lock_fd = acquire_lock();
     if (lock_fd < 0) {
+        ctl_inherit();
+        ctl_refuse();
         g_message("workspace-indicator: already running");
         return 0;
     }
+    trace("lock", t);
+
+    ctl_inherit();
+    hypr_sig = g_strdup(g_getenv("HYPRLAND_INSTANCE_SIGNATURE"));
+    windows_init();
+    state_load();
+    startup_begin();
 
+    t = g_get_monotonic_time();
     gtk_init(&argc, &argv);
+    trace("gtk_init", t);
+
+    for (int i = 1; i < argc; i++) {
+        if (g_str_equal(argv[i], "--all-outputs"))
+            all_outputs = TRUE;
+        else if (g_str_equal(argv[i], "--client-fade"))
+            client_fade = TRUE;
+        else if (g_str_equal(argv[i], "--idle-exit") && i + 1 < argc)
+            idle_exit_s = (guint)MAX(atoi(argv[++i]), 0);
+        else if (!g_str_equal(argv[i], "--startup-trace"))
+            g_warning("workspace-indicator: unknown option %s", argv[i]);
+    }
+
+    palette_watch_init();
 
-    load_palette();
-    build_window();
+    t = g_get_monotonic_time();
+    alpha_modifier_init();
+    build_surfaces();
+    trace("surfaces", t);
 
     g_unix_signal_add(SIGUSR1, on_usr1, NULL);
     g_unix_signal_add(SIGUSR2, on_usr2, NULL);  /* theme-set reload */
+    g_unix_signal_add(SIGHUP,  on_hup,  NULL);  /* stats dump */
     g_unix_signal_add(SIGTERM, on_quit, NULL);
     g_unix_signal_add(SIGINT,  on_quit, NULL);
 
-    pthread_t tid;
-    pthread_create(&tid, NULL, ipc_thread, NULL);
-    pthread_detach(tid);
+    ctl_listen();
+    s2_reader_init(&ipc.rd, ipc_events, G_N_ELEMENTS(ipc_events), BUF_SZ, NULL);
+    startup_finish();
+    idle_arm();
+    trace("ready", startup_t0);
 
     gtk_main();
 
+    ctl_unlisten();
+    state_save();
+    stats_dump();
     close(lock_fd);
     return 0;
 }
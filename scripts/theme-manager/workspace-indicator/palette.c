@@ -0,0 +1,33 @@
+/*
+ * palette.c — hyprland-palette.conf reader (see palette.h)
+ */
+
+#include "palette.h"
+
+#include <string.h>
+
+RGBA hex8_to_rgba(const char *hex)
+{
+    unsigned r = 0, g = 0, b = 0, a = 0xFF;
+    sscanf(hex, "%2x%2x%2x%2x", &r, &g, &b, &a);
+    return (RGBA){ r / 255.0, g / 255.0, b / 255.0, a / 255.0 };
+}
+
+void palette_parse(FILE *f, Palette *p)
+{
+    char line[256];
+    while (fgets(line, sizeof line, f)) {
+        char name[64], hex[9];
+        if (sscanf(line, " $%63[a-zA-Z_] = rgba(%8[0-9a-fA-F])", name, hex) != 2)
+            continue;
+
+        RGBA c = hex8_to_rgba(hex);
+
+        /* Map palette names → indicator roles, preserving per-role alpha */
+        if      (strcmp(name, "background") == 0)  p->bg     = (RGBA){ c.r, c.g, c.b, 0.75 };
+        else if (strcmp(name, "accent") == 0)      p->active = c;
+        else if (strcmp(name, "blue") == 0)        p->active = c; /* blue fallback */
+        else if (strcmp(name, "foreground") == 0)  p->fg     = (RGBA){ c.r, c.g, c.b, 0.55 };
+        else if (strcmp(name, "comment") == 0)     p->dim    = (RGBA){ c.r, c.g, c.b, 0.25 };
+    }
+}
@@ -0,0 +1,30 @@
+/*
+ * palette.h — hyprland-palette.conf reader
+ *
+ * Theme palettes are lines of `$name = rgba(RRGGBBAA)`.  The reader maps
+ * the standard names onto the indicator's four colour roles and leaves
+ * roles the file does not mention untouched, so a partial palette keeps
+ * the previous (or fallback) colours.
+ */
+
+#ifndef WI_PALETTE_H
+#define WI_PALETTE_H
+
+#include <stdio.h>
+
+typedef struct { double r, g, b, a; } RGBA;
+
+typedef struct {
+    RGBA bg;                          /* pill background               */
+    RGBA active;                      /* highlighted workspace         */
+    RGBA fg;                          /* occupied workspace            */
+    RGBA dim;                         /* empty workspace               */
+} Palette;
+
+/* "RRGGBB" or "RRGGBBAA"; missing alpha is opaque. */
+RGBA hex8_to_rgba(const char *hex);
+
+/* Apply every recognised line of f to *p. */
+void palette_parse(FILE *f, Palette *p);
+
+#endif /* WI_PALETTE_H */
@@ -0,0 +1,155 @@
+/*
+ * socket2.c — in-place line splitter and event dispatch (see socket2.h)
+ */
+
+#include "socket2.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    NAME_MAX_LEN = 64,                /* longer "names" are not events   */
+    LINE_MAX_LEN = 1 << 20,           /* handled lines beyond this drop  */
+};
+
+void s2_reader_init(S2Reader *r, const S2Event *events, size_t n_events,
+                    size_t initial_cap, void *user)
+{
+    memset(r, 0, sizeof *r);
+    r->events   = events;
+    r->n_events = n_events;
+    r->user     = user;
+    r->cap      = initial_cap;
+    r->buf      = malloc(initial_cap);
+
+    for (size_t i = 0; i < n_events; i++)
+        if (events[i].len < 32)
+            r->len_mask |= 1u << events[i].len;
+}
+
+void s2_reader_free(S2Reader *r)
+{
+    free(r->buf);
+    r->buf = NULL;
+    r->cap = r->len = 0;
+}
+
+void s2_reader_reset(S2Reader *r)
+{
+    r->len     = 0;
+    r->discard = false;
+}
+
+/*
+ * Resolve the event name of line[0..len).  Returns the handler entry,
+ * NULL for an event nobody handles; *known is false while the ">>" has
+ * not arrived yet and the name cannot be judged.
+ */
+static const S2Event *lookup(const S2Reader *r, const char *line, size_t len,
+                             bool *known)
+{
+    size_t      scan = len < NAME_MAX_LEN ? len : NAME_MAX_LEN;
+    const char *sep  = memchr(line, '>', scan);
+
+    *known = true;
+    if (!sep || (size_t)(sep - line) + 1 >= len) {
+        *known = !sep && len >= NAME_MAX_LEN;
+        return NULL;
+    }
+    if (sep[1] != '>')
+        return NULL;
+
+    size_t nlen = (size_t)(sep - line);
+    if (nlen < 32 && !(r->len_mask & (1u << nlen)))
+        return NULL;
+
+    for (size_t i = 0; i < r->n_events; i++) {
+        const S2Event *e = &r->events[i];
+        if (e->len == nlen && memcmp(e->name, line, nlen) == 0)
+            return e;
+    }
+    return NULL;
+}
+
+static void dispatch(S2Reader *r, char *line, size_t len)
+{
+    bool           known;
+    const S2Event *e = lookup(r, line, len, &known);
+
+    r->lines++;
+    if (!e) return;
+
+    r->dispatched++;
+    e->fn(line + e->len + 2, len - e->len - 2, r->user);
+}
+
+char *s2_reader_space(S2Reader *r, size_t *avail)
+{
+    if (r->len == r->cap) {
+        /* A handled line outgrew the buffer (unhandled ones never get here). */
+        if (r->cap * 2 <= LINE_MAX_LEN) {
+            char *nb = realloc(r->buf, r->cap * 2);
+            if (nb) {
+                r->buf  = nb;
+                r->cap *= 2;
+            }
+        }
+        if (r->len == r->cap) {
+            r->discard = true;
+            r->len     = 0;
+        }
+    }
+    *avail = r->cap - r->len;
+    return r->buf + r->len;
+}
+
+void s2_reader_commit(S2Reader *r, size_t n)
+{
+    char *p    = r->buf + r->len;     /* bytes before p hold no newline */
+    char *end  = p + n;
+    char *line = r->buf;
+    char *nl;
+
+    if (r->discard) {
+        nl = memchr(p, '\n', n);
+        if (!nl) {
+            r->len = 0;
+            return;
+        }
+        r->discard = false;
+        r->lines++;
+        line = p = nl + 1;
+    }
+
+    while ((nl = memchr(p, '\n', (size_t)(end - p))) != NULL) {
+        *nl = '\0';
+        dispatch(r, line, (size_t)(nl - line));
+        line = p = nl + 1;
+    }
+
+    /* Partial tail: keep it only if it may still turn out to be handled. */
+    size_t tail = (size_t)(end - line);
+    bool   known;
+    if (tail && !lookup(r, line, tail, &known) && known) {
+        r->discard = true;
+        r->len     = 0;
+        return;
+    }
+    if (line != r->buf)
+        memmove(r->buf, line, tail);
+    r->len = tail;
+}
+
+void s2_reader_feed(S2Reader *r, const char *data, size_t n)
+{
+    while (n > 0) {
+        size_t avail;
+        char  *dst   = s2_reader_space(r, &avail);
+        size_t chunk = n < avail ? n : avail;
+
+        memcpy(dst, data, chunk);
+        s2_reader_commit(r, chunk);
+        data += chunk;
+        n    -= chunk;
+    }
+}
@@ -0,0 +1,59 @@
+/*
+ * socket2.h — in-place line splitter and event dispatch for Hyprland socket2
+ *
+ * Lines ("name>>payload\n") are split with memchr directly in the receive
+ * buffer and routed through a compile-time table of typed handlers.  Events
+ * nobody handles are dropped without being copied — including the tail of
+ * an arbitrarily long window title still in flight — while handled events
+ * longer than the initial buffer grow it instead of being truncated.
+ */
+
+#ifndef WI_SOCKET2_H
+#define WI_SOCKET2_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* payload is NUL-terminated in place; len excludes the terminator. */
+typedef void (*S2Handler)(char *payload, size_t len, void *user);
+
+typedef struct {
+    const char *name;                 /* event name without ">>" */
+    size_t      len;
+    S2Handler   fn;
+} S2Event;
+
+#define S2_EVENT(name, fn) { name, sizeof(name) - 1, fn }
+
+typedef struct {
+    const S2Event *events;
+    size_t         n_events;
+    uint32_t       len_mask;          /* bit n: some handled name has length n */
+    void          *user;
+
+    char          *buf;
+    size_t         len, cap;
+    bool           discard;           /* skipping to the next newline */
+
+    uint64_t       lines;             /* complete lines seen */
+    uint64_t       dispatched;        /* lines that reached a handler */
+} S2Reader;
+
+void  s2_reader_init(S2Reader *r, const S2Event *events, size_t n_events,
+                     size_t initial_cap, void *user);
+void  s2_reader_free(S2Reader *r);
+
+/* Forget any partial line, e.g. after a reconnect. */
+void  s2_reader_reset(S2Reader *r);
+
+/* Where the next read() should land, and how much fits there. */
+char *s2_reader_space(S2Reader *r, size_t *avail);
+
+/* Process n bytes just read into s2_reader_space(). */
+void  s2_reader_commit(S2Reader *r, size_t n);
+
+/* Copy-in convenience for replay and benchmarks. */
+void  s2_reader_feed(S2Reader *r, const char *data, size_t n);
+
+#endif /* WI_SOCKET2_H */
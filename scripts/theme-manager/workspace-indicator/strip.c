@@ -0,0 +1,101 @@
+/*
+ * strip.c — dot-strip layout (see strip.h)
+ */
+
+#include "strip.h"
+
+#include <string.h>
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+
+/*
+ * Ids that get a dot, in order: workspaces on this output, the active id,
+ * free persistent slots and workspaces no output owns.  Each source keeps
+ * a cursor and only set members are visited (wsset_next() skips gaps a
+ * word at a time), so a walk is O(workspaces), never O(id span).  Unowned
+ * members are rare, so that scan only runs ahead as far as the next dot.
+ */
+typedef struct {
+    const WsSet *view, *all;
+    int          active, slots, hi;
+    int          ws;                  /* last id returned */
+    int          on_view;             /* next member of view, 0 = none */
+    int          unowned;             /* next unowned id, 0 = none up to scanned */
+    int          scanned;
+} Walk;
+
+/* The next id to show, or 0 past hi. */
+static int walk_next(Walk *w)
+{
+    if (w->on_view && w->on_view <= w->ws) w->on_view = wsset_next(w->view, w->ws);
+
+    int best = w->on_view;
+    if (w->active > w->ws && (!best || w->active < best)) best = w->active;
+    int limit = best && best < w->hi ? best : w->hi;
+
+    if (w->unowned <= w->ws) {
+        int from = MAX(w->ws, w->scanned);
+        w->unowned = 0;
+        for (int s = from + 1; s <= MIN(w->slots, limit) && !w->unowned; s++)
+            if (wsset_monitor(w->all, s) < 0) w->unowned = s;
+        if (!w->unowned && limit > MAX(from, w->slots))
+            w->unowned = wsset_next_unowned(w->all, MAX(from, w->slots), limit);
+        w->scanned = w->unowned ? w->unowned : MAX(from, limit);
+    }
+    if (w->unowned && (!best || w->unowned < best)) best = w->unowned;
+
+    return w->ws = best <= w->hi ? best : 0;
+}
+
+/*
+ * One walk: the last n ids are kept in a ring, and the walk stops as soon
+ * as the window around the active id is full; one more step tells
+ * whether anything is hidden to its right.
+ */
+void strip_layout(DotStrip *d, const WsSet *view, const WsSet *all, int active,
+                  const StripParams *p)
+{
+    int lo = view->count ? wsset_next(view, 0) : active;
+    if (lo <= p->persistent || (active >= 1 && active <= p->persistent)) lo = 1;
+    else if (active >= 1) lo = MIN(lo, active);
+    int slots = lo == 1 ? p->persistent : 0;
+
+    Walk w = {
+        .view = view, .all = all, .active = active, .slots = slots,
+        .hi = MAX(MAX(view->max, active), slots), .ws = lo - 1,
+    };
+    w.on_view = wsset_next(view, w.ws);
+
+    int  cap  = MIN(p->max_dots, STRIP_CAP);
+    int  ring[STRIP_CAP];
+    int  len  = 0, pos = 0, ws;
+    bool seen = active < 1;           /* no active dot: the window starts at 0 */
+    bool more = false;
+    while ((ws = walk_next(&w))) {
+        if (seen && len >= MAX(pos - cap / 2, 0) + cap) {
+            more = true;
+            break;
+        }
+        if (ws == active) {
+            pos  = len;
+            seen = true;
+        }
+        ring[len++ % cap] = ws;
+    }
+
+    memset(d, 0, sizeof *d);
+    d->active = active;
+    d->n      = MIN(len, cap);
+    int skip  = pos - d->n / 2;
+    if (skip > len - d->n) skip = len - d->n;
+    if (skip < 0)          skip = 0;
+    d->more_left  = skip > 0;
+    d->more_right = more;
+
+    for (int i = 0; i < d->n; i++) {
+        d->ids[i]      = ring[(skip + i) % cap];
+        d->wins[i]     = (uint8_t)MIN(p->win_count(d->ids[i], p->user), p->win_steps);
+        d->occupied[i] = wsset_has(all, d->ids[i]);
+    }
+}
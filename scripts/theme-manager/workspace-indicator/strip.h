@@ -0,0 +1,49 @@
+/*
+ * strip.h — which workspace dots one output's pill shows
+ *
+ * The strip lists the workspaces on the output, the active id, and any
+ * workspace no output owns yet, over the output's own id span.  When that
+ * span starts within the persistent slots it also shows every free slot
+ * (switching to one creates it on the focused output); gaps above them
+ * get no dot.  Past max_dots it becomes a window centred on the active
+ * id, so the pill never outgrows the output however many workspaces
+ * exist, and laying it out only visits set members.
+ */
+
+#ifndef WI_STRIP_H
+#define WI_STRIP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "wsset.h"
+
+enum { STRIP_CAP = 32 };              /* storage bound for max_dots */
+
+typedef struct {
+    int      ids[STRIP_CAP];
+    uint8_t  wins[STRIP_CAP];         /* window count per dot, capped at win_steps */
+    bool     occupied[STRIP_CAP];     /* dot's workspace exists (in `all`) */
+    int      n;
+    int      active;                  /* highlighted id */
+    bool     more_left, more_right;   /* ids hidden beyond either edge */
+} DotStrip;
+
+typedef struct {
+    int   persistent;                 /* ids 1..persistent always show */
+    int   max_dots;                   /* 1..STRIP_CAP */
+    int   win_steps;
+    int (*win_count)(int ws, void *user);
+    void *user;
+} StripParams;
+
+/*
+ * Lay out the strip for an output showing `view` with `active`
+ * highlighted; `all` is every workspace with its owning monitor.  The
+ * result is zero-padded and carries everything the pill is drawn from
+ * but the palette, so strips can be compared bytewise.
+ */
+void strip_layout(DotStrip *d, const WsSet *view, const WsSet *all, int active,
+                  const StripParams *p);
+
+#endif /* WI_STRIP_H */
@@ -0,0 +1,127 @@
+/*
+ * wsset.c — growable workspace-id set (see wsset.h)
+ */
+
+#include "wsset.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define WORD(id) ((id) >> 6)
+#define BIT(id)  (UINT64_C(1) << ((id) & 63))
+
+void wsset_init(WsSet *s)
+{
+    memset(s, 0, sizeof *s);
+}
+
+void wsset_free(WsSet *s)
+{
+    free(s->bits);
+    free(s->mon);
+    wsset_init(s);
+}
+
+/* Make id addressable; false if it is out of range or memory ran out. */
+static bool reserve(WsSet *s, int id)
+{
+    if (id < 1 || id >= WSSET_ID_LIMIT) return false;
+    if (id < s->cap) return true;
+
+    int cap = s->cap ? s->cap : 64;
+    while (cap <= id) cap *= 2;
+
+    uint64_t *bits = realloc(s->bits, (size_t)(cap / 64) * sizeof *bits);
+    if (!bits) return false;
+    s->bits = bits;
+    int32_t *mon = realloc(s->mon, (size_t)cap * sizeof *mon);
+    if (!mon) return false;
+    s->mon = mon;
+
+    memset(bits + s->cap / 64, 0, (size_t)((cap - s->cap) / 64) * sizeof *bits);
+    for (int i = s->cap; i < cap; i++) mon[i] = -1;
+    s->cap = cap;
+    return true;
+}
+
+bool wsset_has(const WsSet *s, int id)
+{
+    return id > 0 && id < s->cap && (s->bits[WORD(id)] & BIT(id));
+}
+
+void wsset_add(WsSet *s, int id)
+{
+    if (wsset_has(s, id) || !reserve(s, id)) return;
+
+    s->bits[WORD(id)] |= BIT(id);
+    s->count++;
+    if (id > s->max) s->max = id;
+}
+
+void wsset_remove(WsSet *s, int id)
+{
+    if (!wsset_has(s, id)) return;
+
+    s->bits[WORD(id)] &= ~BIT(id);
+    s->count--;
+    if (id != s->max) return;
+
+    for (int w = WORD(id); w >= 0; w--) {
+        if (s->bits[w]) {
+            s->max = w * 64 + 63 - __builtin_clzll(s->bits[w]);
+            return;
+        }
+    }
+    s->max = 0;
+}
+
+int wsset_monitor(const WsSet *s, int id)
+{
+    return id > 0 && id < s->cap ? s->mon[id] : -1;
+}
+
+void wsset_set_monitor(WsSet *s, int id, int mon)
+{
+    if (reserve(s, id)) s->mon[id] = mon;
+}
+
+int wsset_next(const WsSet *s, int id)
+{
+    if (id < 0) id = 0;
+    if (++id >= s->cap) return 0;
+
+    int      w    = WORD(id);
+    uint64_t word = s->bits[w] & ~(BIT(id) - 1);
+    for (;;) {
+        if (word) return w * 64 + __builtin_ctzll(word);
+        if (++w >= s->cap / 64) return 0;
+        word = s->bits[w];
+    }
+}
+
+int wsset_next_unowned(const WsSet *s, int id, int hi)
+{
+    if (id < 0) id = 0;
+    if (hi >= s->cap) hi = s->cap - 1;
+    if (++id > hi) return 0;
+
+    int      w    = WORD(id);
+    uint64_t word = s->bits[w] & ~(BIT(id) - 1);
+    for (;;) {
+        while (word) {
+            int m = w * 64 + __builtin_ctzll(word);
+            if (m > hi) return 0;
+            if (s->mon[m] < 0) return m;
+            word &= word - 1;
+        }
+        if (++w > WORD(hi)) return 0;
+        word = s->bits[w];
+    }
+}
+
+void wsset_replace(WsSet *s, WsSet *src)
+{
+    wsset_free(s);
+    *s = *src;
+    wsset_init(src);
+}
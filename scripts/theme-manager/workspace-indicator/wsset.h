@@ -0,0 +1,45 @@
+/*
+ * wsset.h — growable workspace-id set for the indicator model
+ *
+ * Occupancy is a bitset indexed by workspace id, with a parallel id →
+ * monitor map, both grown on demand so ids are not capped at the number
+ * of dots the pill can show.  Add/remove/lookup are O(1); removing the
+ * highest id rescans downward a word at a time.
+ */
+
+#ifndef WI_WSSET_H
+#define WI_WSSET_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+enum { WSSET_ID_LIMIT = 1 << 16 };   /* ids at or above this are ignored */
+
+typedef struct {
+    uint64_t *bits;
+    int32_t  *mon;                    /* id → Hyprland monitor id, -1 = unknown */
+    int       cap;                    /* ids 0..cap-1 are addressable */
+    int       max;                    /* highest member, 0 when empty */
+    int       count;
+} WsSet;
+
+void wsset_init(WsSet *s);
+void wsset_free(WsSet *s);
+
+bool wsset_has(const WsSet *s, int id);
+void wsset_add(WsSet *s, int id);
+void wsset_remove(WsSet *s, int id);
+
+int  wsset_monitor(const WsSet *s, int id);
+void wsset_set_monitor(WsSet *s, int id, int mon);
+
+/* Smallest member greater than id, or 0 when there is none. */
+int  wsset_next(const WsSet *s, int id);
+
+/* Smallest member in (id, hi] with no known monitor, or 0. */
+int  wsset_next_unowned(const WsSet *s, int id, int hi);
+
+/* Move src's contents into s (src is left empty). */
+void wsset_replace(WsSet *s, WsSet *src);
+
+#endif /* WI_WSSET_H */